@@ -0,0 +1,401 @@
+#include "factorization.h"
+#include "gemm.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace task;
+
+namespace {
+
+    // Columns per LU panel; the update of the trailing matrix is one GEMM per panel.
+    const size_t PANEL = 64;
+
+    std::vector<double> to_dense(const Matrix &matrix) {
+        size_t rows = matrix.getRowsNum();
+        size_t columns = matrix.getColumnsNum();
+
+        std::vector<double> dense(rows * columns);
+        for (size_t i = 0; i < rows; i++) {
+            std::copy(matrix[i], matrix[i] + columns, dense.data() + i * columns);
+        }
+        return dense;
+    }
+
+    Matrix to_matrix(const double *dense, size_t rows, size_t columns) {
+        Matrix new_matrix(rows, columns);
+        for (size_t i = 0; i < rows; i++) {
+            std::copy(dense + i * columns, dense + (i + 1) * columns, new_matrix[i]);
+        }
+        return new_matrix;
+    }
+
+    // y -= factor * x
+    inline void subtract_scaled(double *y, const double *x, double factor, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            y[i] -= factor * x[i];
+        }
+    }
+
+    inline void scale(double *y, double factor, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            y[i] *= factor;
+        }
+    }
+
+}  // namespace
+
+
+bool detail::lu_panel(size_t n, double *a, size_t lda, size_t start, size_t end,
+                      size_t *pivots, bool &odd_permutation) {
+    bool singular = false;
+
+    for (size_t k = start; k < end; k++) {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < n; i++) {
+            if (std::fabs(a[i * lda + k]) > std::fabs(a[pivot * lda + k])) {
+                pivot = i;
+            }
+        }
+
+        pivots[k] = pivot;
+        if (pivot != k) {
+            std::swap_ranges(a + k * lda, a + k * lda + n, a + pivot * lda);
+            odd_permutation = !odd_permutation;
+        }
+
+        double diagonal = a[k * lda + k];
+        if (diagonal == 0.0) {
+            singular = true;
+            continue;
+        }
+
+        for (size_t i = k + 1; i < n; i++) {
+            double *row = a + i * lda;
+            row[k] /= diagonal;
+            subtract_scaled(row + k + 1, a + k * lda + k + 1, row[k], end - k - 1);
+        }
+    }
+
+    return singular;
+}
+
+
+LUFactorization::LUFactorization(const Matrix &matrix)
+        : size(matrix.getRowsNum()), lu(to_dense(matrix)), pivots(matrix.getRowsNum()),
+          odd_permutation(false), singular(false) {
+    if (matrix.getColumnsNum() != this->size) {
+        throw SizeMismatchException();
+    }
+
+    size_t n = this->size;
+    double *a = this->lu.data();
+
+    for (size_t start = 0; start < n; start += PANEL) {
+        size_t end = std::min(start + PANEL, n);
+
+        if (detail::lu_panel(n, a, n, start, end, this->pivots.data(), this->odd_permutation)) {
+            this->singular = true;
+        }
+
+        if (end == n) {
+            break;
+        }
+
+        // U12 = L11^-1 A12, then A22 -= L21 U12.
+        for (size_t i = start + 1; i < end; i++) {
+            for (size_t p = start; p < i; p++) {
+                subtract_scaled(a + i * n + end, a + p * n + end, a[i * n + p], n - end);
+            }
+        }
+        detail::gemm(n - end, n - end, end - start,
+                     -1.0, a + end * n + start, n, a + start * n + end, n,
+                     1.0, a + end * n + end, n);
+    }
+}
+
+void LUFactorization::solve_in_place(double *x, size_t rhs) const {
+    if (this->singular) {
+        throw SingularMatrixException();
+    }
+
+    size_t n = this->size;
+    const double *a = this->lu.data();
+
+    for (size_t k = 0; k < n; k++) {
+        if (this->pivots[k] != k) {
+            std::swap_ranges(x + k * rhs, x + (k + 1) * rhs, x + this->pivots[k] * rhs);
+        }
+    }
+
+    for (size_t i = 1; i < n; i++) {
+        for (size_t p = 0; p < i; p++) {
+            subtract_scaled(x + i * rhs, x + p * rhs, a[i * n + p], rhs);
+        }
+    }
+
+    for (size_t i = n; i-- > 0;) {
+        for (size_t p = i + 1; p < n; p++) {
+            subtract_scaled(x + i * rhs, x + p * rhs, a[i * n + p], rhs);
+        }
+        scale(x + i * rhs, 1.0 / a[i * n + i], rhs);
+    }
+}
+
+std::vector<double> LUFactorization::solve(const std::vector<double> &b) const {
+    if (b.size() != this->size) {
+        throw SizeMismatchException();
+    }
+
+    std::vector<double> x(b);
+    solve_in_place(x.data(), 1);
+    return x;
+}
+
+Matrix LUFactorization::solve(const Matrix &b) const {
+    if (b.getRowsNum() != this->size) {
+        throw SizeMismatchException();
+    }
+
+    std::vector<double> x = to_dense(b);
+    solve_in_place(x.data(), b.getColumnsNum());
+    return to_matrix(x.data(), this->size, b.getColumnsNum());
+}
+
+Matrix LUFactorization::inverse() const {
+    return solve(Matrix(this->size, this->size));
+}
+
+double LUFactorization::det() const {
+    double det = this->odd_permutation ? -1.0 : 1.0;
+    for (size_t i = 0; i < this->size; i++) {
+        det *= this->lu[i * this->size + i];
+    }
+    return det;
+}
+
+
+CholeskyFactorization::CholeskyFactorization(const Matrix &matrix)
+        : size(matrix.getRowsNum()), l(to_dense(matrix)) {
+    if (matrix.getColumnsNum() != this->size) {
+        throw SizeMismatchException();
+    }
+
+    size_t n = this->size;
+    double *a = this->l.data();
+
+    // Row by row: every entry is a contiguous dot product of two rows already computed.
+    for (size_t i = 0; i < n; i++) {
+        double *row = a + i * n;
+
+        for (size_t j = 0; j <= i; j++) {
+            const double *other = a + j * n;
+
+            double sum = row[j];
+            for (size_t p = 0; p < j; p++) {
+                sum -= row[p] * other[p];
+            }
+
+            if (j < i) {
+                row[j] = sum / other[j];
+            } else if (sum > 0.0) {
+                row[i] = std::sqrt(sum);
+            } else {
+                throw NotPositiveDefiniteException();
+            }
+        }
+        std::fill(row + i + 1, row + n, 0.0);
+    }
+}
+
+void CholeskyFactorization::solve_in_place(double *x, size_t rhs) const {
+    size_t n = this->size;
+    const double *a = this->l.data();
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t p = 0; p < i; p++) {
+            subtract_scaled(x + i * rhs, x + p * rhs, a[i * n + p], rhs);
+        }
+        scale(x + i * rhs, 1.0 / a[i * n + i], rhs);
+    }
+
+    // L^T is walked through the rows of L, so the back substitution is column oriented.
+    for (size_t i = n; i-- > 0;) {
+        scale(x + i * rhs, 1.0 / a[i * n + i], rhs);
+        for (size_t p = 0; p < i; p++) {
+            subtract_scaled(x + p * rhs, x + i * rhs, a[i * n + p], rhs);
+        }
+    }
+}
+
+std::vector<double> CholeskyFactorization::solve(const std::vector<double> &b) const {
+    if (b.size() != this->size) {
+        throw SizeMismatchException();
+    }
+
+    std::vector<double> x(b);
+    solve_in_place(x.data(), 1);
+    return x;
+}
+
+Matrix CholeskyFactorization::solve(const Matrix &b) const {
+    if (b.getRowsNum() != this->size) {
+        throw SizeMismatchException();
+    }
+
+    std::vector<double> x = to_dense(b);
+    solve_in_place(x.data(), b.getColumnsNum());
+    return to_matrix(x.data(), this->size, b.getColumnsNum());
+}
+
+Matrix CholeskyFactorization::inverse() const {
+    return solve(Matrix(this->size, this->size));
+}
+
+double CholeskyFactorization::det() const {
+    double det = 1.0;
+    for (size_t i = 0; i < this->size; i++) {
+        det *= this->l[i * this->size + i];
+    }
+    return det * det;
+}
+
+
+QRFactorization::QRFactorization(const Matrix &matrix)
+        : rows(matrix.getRowsNum()), columns(matrix.getColumnsNum()), qr(to_dense(matrix)),
+          tau(matrix.getColumnsNum(), 0.0) {
+    if (this->rows < this->columns) {
+        throw SizeMismatchException();
+    }
+
+    size_t m = this->rows;
+    size_t n = this->columns;
+    double *a = this->qr.data();
+    std::vector<double> w(n);
+
+    for (size_t k = 0; k < n; k++) {
+        // Reflector H = I - tau v v^T with v[k] = 1 that maps column k onto beta e_k;
+        // v[k + 1:] is stored below the diagonal.
+        double norm = 0.0;
+        for (size_t i = k + 1; i < m; i++) {
+            norm += a[i * n + k] * a[i * n + k];
+        }
+        if (norm == 0.0) {
+            continue;
+        }
+
+        double alpha = a[k * n + k];
+        double beta = -std::copysign(std::hypot(alpha, std::sqrt(norm)), alpha);
+        this->tau[k] = (beta - alpha) / beta;
+
+        double factor = 1.0 / (alpha - beta);
+        for (size_t i = k + 1; i < m; i++) {
+            a[i * n + k] *= factor;
+        }
+        a[k * n + k] = beta;
+
+        // Apply H to the trailing columns one row at a time: w = v^T A, A -= tau v w^T.
+        size_t width = n - k - 1;
+        double *rest = w.data();
+        std::copy(a + k * n + k + 1, a + (k + 1) * n, rest);
+        for (size_t i = k + 1; i < m; i++) {
+            subtract_scaled(rest, a + i * n + k + 1, -a[i * n + k], width);
+        }
+        scale(rest, this->tau[k], width);
+
+        subtract_scaled(a + k * n + k + 1, rest, 1.0, width);
+        for (size_t i = k + 1; i < m; i++) {
+            subtract_scaled(a + i * n + k + 1, rest, a[i * n + k], width);
+        }
+    }
+}
+
+void QRFactorization::solve_in_place(double *x, size_t rhs) const {
+    size_t m = this->rows;
+    size_t n = this->columns;
+    const double *a = this->qr.data();
+
+    for (size_t i = 0; i < n; i++) {
+        if (a[i * n + i] == 0.0) {
+            throw SingularMatrixException();
+        }
+    }
+
+    // x = Q^T x
+    std::vector<double> w(rhs);
+    for (size_t k = 0; k < n; k++) {
+        if (this->tau[k] == 0.0) {
+            continue;
+        }
+
+        std::copy(x + k * rhs, x + (k + 1) * rhs, w.data());
+        for (size_t i = k + 1; i < m; i++) {
+            subtract_scaled(w.data(), x + i * rhs, -a[i * n + k], rhs);
+        }
+        scale(w.data(), this->tau[k], rhs);
+
+        subtract_scaled(x + k * rhs, w.data(), 1.0, rhs);
+        for (size_t i = k + 1; i < m; i++) {
+            subtract_scaled(x + i * rhs, w.data(), a[i * n + k], rhs);
+        }
+    }
+
+    // R x = (Q^T b)[:n]
+    for (size_t i = n; i-- > 0;) {
+        for (size_t p = i + 1; p < n; p++) {
+            subtract_scaled(x + i * rhs, x + p * rhs, a[i * n + p], rhs);
+        }
+        scale(x + i * rhs, 1.0 / a[i * n + i], rhs);
+    }
+}
+
+std::vector<double> QRFactorization::solve(const std::vector<double> &b) const {
+    if (b.size() != this->rows) {
+        throw SizeMismatchException();
+    }
+
+    std::vector<double> x(b);
+    solve_in_place(x.data(), 1);
+    x.resize(this->columns);
+    return x;
+}
+
+Matrix QRFactorization::solve(const Matrix &b) const {
+    if (b.getRowsNum() != this->rows) {
+        throw SizeMismatchException();
+    }
+
+    std::vector<double> x = to_dense(b);
+    solve_in_place(x.data(), b.getColumnsNum());
+    return to_matrix(x.data(), this->columns, b.getColumnsNum());
+}
+
+Matrix QRFactorization::inverse() const {
+    if (this->rows != this->columns) {
+        throw SizeMismatchException();
+    }
+    return solve(Matrix(this->rows, this->columns));
+}
+
+double QRFactorization::det() const {
+    if (this->rows != this->columns) {
+        throw SizeMismatchException();
+    }
+
+    // Every non-trivial reflector has determinant -1.
+    double det = 1.0;
+    for (size_t i = 0; i < this->columns; i++) {
+        det *= this->tau[i] == 0.0 ? this->qr[i * this->columns + i] : -this->qr[i * this->columns + i];
+    }
+    return det;
+}
+
+Matrix QRFactorization::getR() const {
+    size_t n = this->columns;
+
+    Matrix new_matrix(n, n);
+    for (size_t i = 0; i < n; i++) {
+        std::fill(new_matrix[i], new_matrix[i] + i, 0.0);
+        std::copy(this->qr.data() + i * n + i, this->qr.data() + (i + 1) * n, new_matrix[i] + i);
+    }
+    return new_matrix;
+}
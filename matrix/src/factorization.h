@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "matrix.h"
+
+
+namespace task {
+
+    class SingularMatrixException : public std::exception {
+    };
+
+    class NotPositiveDefiniteException : public std::exception {
+    };
+
+    namespace detail {
+
+        // Partial-pivoting elimination of columns [start, end) of the n x n row-major a (leading
+        // dimension lda). Row swaps cover whole rows, multipliers of L overwrite the entries below
+        // the diagonal, and only columns before end are updated. pivots[k] receives the row swapped
+        // into row k and every swap flips odd_permutation. A zero pivot leaves its column as is;
+        // the return value tells whether that happened.
+        bool lu_panel(size_t n, double *a, size_t lda, size_t start, size_t end,
+                      size_t *pivots, bool &odd_permutation);
+
+    }  // namespace detail
+
+
+    // P A = L U with partial pivoting, factored in column panels whose trailing update goes
+    // through the blocked GEMM. A singular matrix still factors (det() is 0); solve() and
+    // inverse() then throw SingularMatrixException.
+    class LUFactorization {
+        size_t size;
+        std::vector<double> lu;
+        std::vector<size_t> pivots;
+        bool odd_permutation;
+        bool singular;
+
+        void solve_in_place(double *x, size_t rhs) const;
+
+    public:
+
+        explicit LUFactorization(const Matrix &matrix);
+
+        std::vector<double> solve(const std::vector<double> &b) const;
+
+        Matrix solve(const Matrix &b) const;
+
+        Matrix inverse() const;
+
+        double det() const;
+    };
+
+
+    // A = L L^T for symmetric positive definite A; only the lower triangle of A is read.
+    // Throws NotPositiveDefiniteException when a pivot is not positive.
+    class CholeskyFactorization {
+        size_t size;
+        std::vector<double> l;
+
+        void solve_in_place(double *x, size_t rhs) const;
+
+    public:
+
+        explicit CholeskyFactorization(const Matrix &matrix);
+
+        std::vector<double> solve(const std::vector<double> &b) const;
+
+        Matrix solve(const Matrix &b) const;
+
+        Matrix inverse() const;
+
+        double det() const;
+    };
+
+
+    // A = Q R for m x n A with m >= n, with Q kept as n Householder reflectors. solve()
+    // returns the least-squares solution and throws SingularMatrixException if A is rank
+    // deficient; inverse() and det() need a square A.
+    class QRFactorization {
+        size_t rows;
+        size_t columns;
+        std::vector<double> qr;
+        std::vector<double> tau;
+
+        void solve_in_place(double *x, size_t rhs) const;
+
+    public:
+
+        explicit QRFactorization(const Matrix &matrix);
+
+        std::vector<double> solve(const std::vector<double> &b) const;
+
+        // b has as many rows as A; the result is columns x b.getColumnsNum().
+        Matrix solve(const Matrix &b) const;
+
+        Matrix inverse() const;
+
+        double det() const;
+
+        // The n x n upper triangular factor.
+        Matrix getR() const;
+    };
+
+}  // namespace task
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include "matrix.h"
+
+
+namespace task {
+
+    namespace detail {
+
+        // Calls f(std::integral_constant<size_t, 0>) ... f(std::integral_constant<size_t, N - 1>) with no loop left behind.
+        template<size_t N, class F>
+        constexpr void unroll(F &&f);
+
+    }  // namespace detail
+
+    // R x C matrix with inline storage. Dimensions are template parameters, so shape
+    // mismatches in +, -, * are compile errors and every kernel is unrolled.
+    // Converts to Matrix implicitly and from Matrix explicitly (throwing SizeMismatchException).
+    template<size_t R, size_t C>
+    class FixedMatrix {
+        static_assert(R > 0 && C > 0, "FixedMatrix dimensions must be positive");
+
+        double values[R * C];
+
+    public:
+
+        constexpr FixedMatrix();
+
+        explicit FixedMatrix(const Matrix &matrix);
+
+        operator Matrix() const;
+
+        static constexpr size_t getRowsNum();
+
+        static constexpr size_t getColumnsNum();
+
+        constexpr double &operator()(size_t row, size_t col);
+
+        constexpr const double &operator()(size_t row, size_t col) const;
+
+        double &get(size_t row, size_t col);
+
+        const double &get(size_t row, size_t col) const;
+
+        void set(size_t row, size_t col, const double &value);
+
+        constexpr double *operator[](size_t row);
+
+        constexpr double const *operator[](size_t row) const;
+
+        MatrixView view();
+
+        ConstMatrixView view() const;
+
+        constexpr FixedMatrix &operator+=(const FixedMatrix &a);
+
+        constexpr FixedMatrix &operator-=(const FixedMatrix &a);
+
+        constexpr FixedMatrix &operator*=(const double &number);
+
+        constexpr FixedMatrix operator+(const FixedMatrix &a) const;
+
+        constexpr FixedMatrix operator-(const FixedMatrix &a) const;
+
+        template<size_t K>
+        constexpr FixedMatrix<R, K> operator*(const FixedMatrix<C, K> &a) const;
+
+        constexpr FixedMatrix operator*(const double &a) const;
+
+        constexpr FixedMatrix operator-() const;
+
+        constexpr FixedMatrix operator+() const;
+
+        constexpr double det() const;
+
+        constexpr void transpose();
+
+        constexpr FixedMatrix<C, R> transposed() const;
+
+        constexpr double trace() const;
+
+        constexpr bool operator==(const FixedMatrix &a) const;
+
+        constexpr bool operator!=(const FixedMatrix &a) const;
+    };
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> operator*(const double &a, const FixedMatrix<R, C> &b);
+
+    template<size_t R, size_t C>
+    std::ostream &operator<<(std::ostream &output, const FixedMatrix<R, C> &matrix);
+
+    using Matrix2 = FixedMatrix<2, 2>;
+
+    using Matrix3 = FixedMatrix<3, 3>;
+
+    using Matrix4 = FixedMatrix<4, 4>;
+
+}  // namespace task
+
+
+#include "fixed_matrix.tpp"
@@ -0,0 +1,307 @@
+#include "fixed_matrix.h"
+
+namespace task {
+
+    namespace detail {
+
+        template<class F, size_t... I>
+        constexpr void unroll_impl(F &&f, std::index_sequence<I...>) {
+            (f(std::integral_constant<size_t, I>()), ...);
+        }
+
+        template<size_t N, class F>
+        constexpr void unroll(F &&f) {
+            unroll_impl(std::forward<F>(f), std::make_index_sequence<N>());
+        }
+
+    }  // namespace detail
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C>::FixedMatrix() : values() {
+        detail::unroll<(R < C ? R : C)>([&](auto i) {
+            this->values[i * C + i] = 1.0;
+        });
+    }
+
+    template<size_t R, size_t C>
+    FixedMatrix<R, C>::FixedMatrix(const Matrix &matrix) : values() {
+        if (matrix.getRowsNum() != R || matrix.getColumnsNum() != C) {
+            throw SizeMismatchException();
+        }
+        detail::unroll<R>([&](auto i) {
+            const double *row = matrix[i];
+            detail::unroll<C>([&](auto j) {
+                this->values[i * C + j] = row[j];
+            });
+        });
+    }
+
+    template<size_t R, size_t C>
+    FixedMatrix<R, C>::operator Matrix() const {
+        return Matrix(view());
+    }
+
+    template<size_t R, size_t C>
+    constexpr size_t FixedMatrix<R, C>::getRowsNum() {
+        return R;
+    }
+
+    template<size_t R, size_t C>
+    constexpr size_t FixedMatrix<R, C>::getColumnsNum() {
+        return C;
+    }
+
+    template<size_t R, size_t C>
+    constexpr double &FixedMatrix<R, C>::operator()(size_t row, size_t col) {
+        return this->values[row * C + col];
+    }
+
+    template<size_t R, size_t C>
+    constexpr const double &FixedMatrix<R, C>::operator()(size_t row, size_t col) const {
+        return this->values[row * C + col];
+    }
+
+    template<size_t R, size_t C>
+    double &FixedMatrix<R, C>::get(size_t row, size_t col) {
+        if (row >= R || col >= C) {
+            throw OutOfBoundsException();
+        }
+        return this->values[row * C + col];
+    }
+
+    template<size_t R, size_t C>
+    const double &FixedMatrix<R, C>::get(size_t row, size_t col) const {
+        if (row >= R || col >= C) {
+            throw OutOfBoundsException();
+        }
+        return this->values[row * C + col];
+    }
+
+    template<size_t R, size_t C>
+    void FixedMatrix<R, C>::set(size_t row, size_t col, const double &value) {
+        get(row, col) = value;
+    }
+
+    template<size_t R, size_t C>
+    constexpr double *FixedMatrix<R, C>::operator[](size_t row) {
+        return this->values + row * C;
+    }
+
+    template<size_t R, size_t C>
+    constexpr double const *FixedMatrix<R, C>::operator[](size_t row) const {
+        return this->values + row * C;
+    }
+
+    template<size_t R, size_t C>
+    MatrixView FixedMatrix<R, C>::view() {
+        return MatrixView(this->values, R, C, C, 1);
+    }
+
+    template<size_t R, size_t C>
+    ConstMatrixView FixedMatrix<R, C>::view() const {
+        return ConstMatrixView(this->values, R, C, C, 1);
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> &FixedMatrix<R, C>::operator+=(const FixedMatrix &a) {
+        detail::unroll<R * C>([&](auto i) {
+            this->values[i] += a.values[i];
+        });
+        return *this;
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> &FixedMatrix<R, C>::operator-=(const FixedMatrix &a) {
+        detail::unroll<R * C>([&](auto i) {
+            this->values[i] -= a.values[i];
+        });
+        return *this;
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> &FixedMatrix<R, C>::operator*=(const double &number) {
+        detail::unroll<R * C>([&](auto i) {
+            this->values[i] *= number;
+        });
+        return *this;
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> FixedMatrix<R, C>::operator+(const FixedMatrix &a) const {
+        FixedMatrix new_matrix(*this);
+        new_matrix += a;
+        return new_matrix;
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> FixedMatrix<R, C>::operator-(const FixedMatrix &a) const {
+        FixedMatrix new_matrix(*this);
+        new_matrix -= a;
+        return new_matrix;
+    }
+
+    template<size_t R, size_t C>
+    template<size_t K>
+    constexpr FixedMatrix<R, K> FixedMatrix<R, C>::operator*(const FixedMatrix<C, K> &a) const {
+        FixedMatrix<R, K> new_matrix;
+        detail::unroll<R>([&](auto i) {
+            detail::unroll<K>([&](auto j) {
+                double sum = 0.0;
+                detail::unroll<C>([&](auto k) {
+                    sum += (*this)(i, k) * a(k, j);
+                });
+                new_matrix(i, j) = sum;
+            });
+        });
+        return new_matrix;
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> FixedMatrix<R, C>::operator*(const double &a) const {
+        FixedMatrix new_matrix(*this);
+        new_matrix *= a;
+        return new_matrix;
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> FixedMatrix<R, C>::operator-() const {
+        return *this * -1.0;
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> FixedMatrix<R, C>::operator+() const {
+        return *this;
+    }
+
+    template<size_t R, size_t C>
+    constexpr double FixedMatrix<R, C>::det() const {
+        static_assert(R == C, "det() requires a square matrix");
+
+        const FixedMatrix &m = *this;
+
+        if constexpr (R == 1) {
+            return m(0, 0);
+        } else if constexpr (R == 2) {
+            return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+        } else if constexpr (R == 3) {
+            return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1))
+                   - m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0))
+                   + m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+        } else if constexpr (R == 4) {
+            // Laplace expansion over the 2x2 minors of the top and bottom row pairs.
+            double s0 = m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1);
+            double s1 = m(0, 0) * m(1, 2) - m(1, 0) * m(0, 2);
+            double s2 = m(0, 0) * m(1, 3) - m(1, 0) * m(0, 3);
+            double s3 = m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2);
+            double s4 = m(0, 1) * m(1, 3) - m(1, 1) * m(0, 3);
+            double s5 = m(0, 2) * m(1, 3) - m(1, 2) * m(0, 3);
+
+            double c5 = m(2, 2) * m(3, 3) - m(3, 2) * m(2, 3);
+            double c4 = m(2, 1) * m(3, 3) - m(3, 1) * m(2, 3);
+            double c3 = m(2, 1) * m(3, 2) - m(3, 1) * m(2, 2);
+            double c2 = m(2, 0) * m(3, 3) - m(3, 0) * m(2, 3);
+            double c1 = m(2, 0) * m(3, 2) - m(3, 0) * m(2, 2);
+            double c0 = m(2, 0) * m(3, 1) - m(3, 0) * m(2, 1);
+
+            return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        } else {
+            FixedMatrix lu(*this);
+            double det = 1.0;
+
+            for (size_t k = 0; k < R; k++) {
+                size_t pivot = k;
+                for (size_t i = k + 1; i < R; i++) {
+                    double candidate = lu(i, k) < 0 ? -lu(i, k) : lu(i, k);
+                    double best = lu(pivot, k) < 0 ? -lu(pivot, k) : lu(pivot, k);
+                    if (candidate > best) {
+                        pivot = i;
+                    }
+                }
+                if (lu(pivot, k) == 0.0) {
+                    return 0.0;
+                }
+                if (pivot != k) {
+                    for (size_t j = k; j < R; j++) {
+                        double tmp = lu(k, j);
+                        lu(k, j) = lu(pivot, j);
+                        lu(pivot, j) = tmp;
+                    }
+                    det = -det;
+                }
+
+                det *= lu(k, k);
+                for (size_t i = k + 1; i < R; i++) {
+                    double factor = lu(i, k) / lu(k, k);
+                    for (size_t j = k + 1; j < R; j++) {
+                        lu(i, j) -= factor * lu(k, j);
+                    }
+                }
+            }
+
+            return det;
+        }
+    }
+
+    template<size_t R, size_t C>
+    constexpr void FixedMatrix<R, C>::transpose() {
+        static_assert(R == C, "in-place transpose() requires a square matrix, use transposed()");
+
+        detail::unroll<R>([&](auto i) {
+            detail::unroll<C>([&](auto j) {
+                if constexpr (i < j) {
+                    double tmp = (*this)(i, j);
+                    (*this)(i, j) = (*this)(j, i);
+                    (*this)(j, i) = tmp;
+                }
+            });
+        });
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<C, R> FixedMatrix<R, C>::transposed() const {
+        FixedMatrix<C, R> new_matrix;
+        detail::unroll<R>([&](auto i) {
+            detail::unroll<C>([&](auto j) {
+                new_matrix(j, i) = (*this)(i, j);
+            });
+        });
+        return new_matrix;
+    }
+
+    template<size_t R, size_t C>
+    constexpr double FixedMatrix<R, C>::trace() const {
+        static_assert(R == C, "trace() requires a square matrix");
+
+        double result = 0.0;
+        detail::unroll<R>([&](auto i) {
+            result += (*this)(i, i);
+        });
+        return result;
+    }
+
+    template<size_t R, size_t C>
+    constexpr bool FixedMatrix<R, C>::operator==(const FixedMatrix &a) const {
+        bool equal = true;
+        detail::unroll<R * C>([&](auto i) {
+            double difference = this->values[i] - a.values[i];
+            equal = equal && difference <= EPS && -difference <= EPS;
+        });
+        return equal;
+    }
+
+    template<size_t R, size_t C>
+    constexpr bool FixedMatrix<R, C>::operator!=(const FixedMatrix &a) const {
+        return !(*this == a);
+    }
+
+    template<size_t R, size_t C>
+    constexpr FixedMatrix<R, C> operator*(const double &a, const FixedMatrix<R, C> &b) {
+        return b * a;
+    }
+
+    template<size_t R, size_t C>
+    std::ostream &operator<<(std::ostream &output, const FixedMatrix<R, C> &matrix) {
+        return output << Matrix(matrix);
+    }
+
+}  // namespace task
@@ -0,0 +1,221 @@
+#include "gemm.h"
+#include "thread_pool.h"
+#include <memory>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MATRIX_X86_KERNELS
+#endif
+
+using namespace task;
+
+namespace {
+
+    // Register tile of the micro-kernel and cache blocking of the packed panels:
+    // an MC x KC block of A stays in L2, a KC x NR sliver of B stays in L1.
+    const size_t MR = 4;
+    const size_t NR = 8;
+    const size_t MC = 128;
+    const size_t KC = 256;
+    const size_t NC = 256;
+
+    // A(i, p) is a[i * rsa + p * csa] and B(p, j) is b[p * rsb + j * csb], so transposed
+    // operands are packed straight from their storage.
+    void pack_a(size_t mc, size_t kc, const double *a, size_t rsa, size_t csa, double *packed) {
+        for (size_t i = 0; i < mc; i += MR) {
+            size_t mr = std::min(MR, mc - i);
+            for (size_t p = 0; p < kc; p++) {
+                for (size_t r = 0; r < mr; r++) {
+                    packed[r] = a[(i + r) * rsa + p * csa];
+                }
+                for (size_t r = mr; r < MR; r++) {
+                    packed[r] = 0.0;
+                }
+                packed += MR;
+            }
+        }
+    }
+
+    void pack_b(size_t kc, size_t nc, const double *b, size_t rsb, size_t csb, double *packed) {
+        if (csb != 1) {
+            // Transposed B: walk each column of the sliver along its contiguous direction.
+            for (size_t j = 0; j < nc; j += NR) {
+                size_t nr = std::min(NR, nc - j);
+                for (size_t r = 0; r < NR; r++) {
+                    const double *column = b + (j + r) * csb;
+                    for (size_t p = 0; p < kc; p++) {
+                        packed[p * NR + r] = r < nr ? column[p * rsb] : 0.0;
+                    }
+                }
+                packed += kc * NR;
+            }
+            return;
+        }
+
+        for (size_t j = 0; j < nc; j += NR) {
+            size_t nr = std::min(NR, nc - j);
+            for (size_t p = 0; p < kc; p++) {
+                const double *row = b + p * rsb + j;
+                for (size_t r = 0; r < nr; r++) {
+                    packed[r] = row[r];
+                }
+                for (size_t r = nr; r < NR; r++) {
+                    packed[r] = 0.0;
+                }
+                packed += NR;
+            }
+        }
+    }
+
+    // C[mr x nr] += alpha * Apanel * Bpanel, both panels zero-padded to MR / NR.
+    void micro_kernel(size_t kc, double alpha, const double *a, const double *b,
+                      double *c, size_t ldc, size_t mr, size_t nr) {
+        double ab[MR][NR] = {};
+
+        for (size_t p = 0; p < kc; p++) {
+            for (size_t i = 0; i < MR; i++) {
+                for (size_t j = 0; j < NR; j++) {
+                    ab[i][j] += a[i] * b[j];
+                }
+            }
+            a += MR;
+            b += NR;
+        }
+
+        for (size_t i = 0; i < mr; i++) {
+            for (size_t j = 0; j < nr; j++) {
+                c[i * ldc + j] += alpha * ab[i][j];
+            }
+        }
+    }
+
+    using MicroKernel = void (*)(size_t, double, const double *, const double *, double *, size_t, size_t, size_t);
+
+#ifdef MATRIX_X86_KERNELS
+
+    // The same tile in eight ymm accumulators: each step broadcasts the four A values of a
+    // column against the two halves of a B row, with fused multiply-adds.
+    __attribute__((target("avx2,fma")))
+    void micro_kernel_avx2(size_t kc, double alpha, const double *a, const double *b,
+                           double *c, size_t ldc, size_t mr, size_t nr) {
+        __m256d ab[MR][2];
+        for (size_t i = 0; i < MR; i++) {
+            ab[i][0] = _mm256_setzero_pd();
+            ab[i][1] = _mm256_setzero_pd();
+        }
+
+        for (size_t p = 0; p < kc; p++) {
+            __m256d b0 = _mm256_loadu_pd(b);
+            __m256d b1 = _mm256_loadu_pd(b + 4);
+            for (size_t i = 0; i < MR; i++) {
+                __m256d ai = _mm256_broadcast_sd(a + i);
+                ab[i][0] = _mm256_fmadd_pd(ai, b0, ab[i][0]);
+                ab[i][1] = _mm256_fmadd_pd(ai, b1, ab[i][1]);
+            }
+            a += MR;
+            b += NR;
+        }
+
+        __m256d f = _mm256_set1_pd(alpha);
+        if (mr == MR && nr == NR) {
+            for (size_t i = 0; i < MR; i++) {
+                double *row = c + i * ldc;
+                _mm256_storeu_pd(row, _mm256_fmadd_pd(f, ab[i][0], _mm256_loadu_pd(row)));
+                _mm256_storeu_pd(row + 4, _mm256_fmadd_pd(f, ab[i][1], _mm256_loadu_pd(row + 4)));
+            }
+            return;
+        }
+
+        double edge[MR][NR];
+        for (size_t i = 0; i < MR; i++) {
+            _mm256_storeu_pd(edge[i], _mm256_mul_pd(f, ab[i][0]));
+            _mm256_storeu_pd(edge[i] + 4, _mm256_mul_pd(f, ab[i][1]));
+        }
+        for (size_t i = 0; i < mr; i++) {
+            for (size_t j = 0; j < nr; j++) {
+                c[i * ldc + j] += edge[i][j];
+            }
+        }
+    }
+
+#endif
+
+    MicroKernel select_micro_kernel() {
+#ifdef MATRIX_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return micro_kernel_avx2;
+        }
+#endif
+        return micro_kernel;
+    }
+
+    // Computes one mc x nc tile of C over the whole k range with per-thread packing buffers.
+    void gemm_tile(size_t mc, size_t nc, size_t k, double alpha,
+                   const double *a, size_t rsa, size_t csa, const double *b, size_t rsb, size_t csb,
+                   double *c, size_t ldc) {
+        thread_local std::unique_ptr<double[]> packed_a(new double[MC * KC]);
+        thread_local std::unique_ptr<double[]> packed_b(new double[KC * NC]);
+        static const MicroKernel kernel = select_micro_kernel();
+
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = std::min(KC, k - pc);
+            pack_b(kc, nc, b + pc * rsb, rsb, csb, packed_b.get());
+            pack_a(mc, kc, a + pc * csa, rsa, csa, packed_a.get());
+
+            for (size_t jr = 0; jr < nc; jr += NR) {
+                for (size_t ir = 0; ir < mc; ir += MR) {
+                    kernel(kc, alpha, packed_a.get() + ir * kc, packed_b.get() + jr * kc,
+                           c + ir * ldc + jr, ldc,
+                           std::min(MR, mc - ir), std::min(NR, nc - jr));
+                }
+            }
+        }
+    }
+
+    void scale(size_t m, size_t n, double beta, double *c, size_t ldc) {
+        if (beta == 1.0) {
+            return;
+        }
+        for (size_t i = 0; i < m; i++) {
+            double *row = c + i * ldc;
+            if (beta == 0.0) {
+                std::fill(row, row + n, 0.0);
+            } else {
+                for (size_t j = 0; j < n; j++) {
+                    row[j] *= beta;
+                }
+            }
+        }
+    }
+
+}  // namespace
+
+void detail::gemm(size_t m, size_t n, size_t k,
+                  double alpha, const double *a, size_t lda,
+                  const double *b, size_t ldb,
+                  double beta, double *c, size_t ldc) {
+    gemm(m, n, k, alpha, a, lda, 1, b, ldb, 1, beta, c, ldc);
+}
+
+void detail::gemm(size_t m, size_t n, size_t k,
+                  double alpha, const double *a, size_t rsa, size_t csa,
+                  const double *b, size_t rsb, size_t csb,
+                  double beta, double *c, size_t ldc) {
+    scale(m, n, beta, c, ldc);
+    if (m == 0 || n == 0 || k == 0 || alpha == 0.0) {
+        return;
+    }
+
+    // One task per MC x NC tile of C, each accumulating over k in the same order.
+    size_t row_tiles = (m + MC - 1) / MC;
+    size_t column_tiles = (n + NC - 1) / NC;
+
+    parallel_ranges(row_tiles * column_tiles, 1, m * n * k, [&](size_t t, size_t, size_t) {
+        size_t ic = t / column_tiles * MC;
+        size_t jc = t % column_tiles * NC;
+        gemm_tile(std::min(MC, m - ic), std::min(NC, n - jc), k, alpha,
+                  a + ic * rsa, rsa, csa, b + jc * csb, rsb, csb, c + ic * ldc + jc, ldc);
+    });
+}
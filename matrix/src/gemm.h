@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace task {
+
+    namespace detail {
+
+        // C = alpha * A * B + beta * C for row-major A (m x k), B (k x n), C (m x n).
+        void gemm(size_t m, size_t n, size_t k,
+                  double alpha, const double *a, size_t lda,
+                  const double *b, size_t ldb,
+                  double beta, double *c, size_t ldc);
+
+        // Same product with A(i, p) = a[i * rsa + p * csa] and B(p, j) = b[p * rsb + j * csb]:
+        // a transposed operand is passed by swapping its strides instead of being copied.
+        void gemm(size_t m, size_t n, size_t k,
+                  double alpha, const double *a, size_t rsa, size_t csa,
+                  const double *b, size_t rsb, size_t csb,
+                  double beta, double *c, size_t ldc);
+
+    }  // namespace detail
+
+}  // namespace task
@@ -0,0 +1,47 @@
+#include "gemv.h"
+#include "kernels.h"
+#include "thread_pool.h"
+#include <algorithm>
+
+using namespace task;
+
+namespace {
+
+    // One range per thread, rounded to whole cache lines of y.
+    size_t range_length(size_t count) {
+        size_t threads = get_num_threads();
+        return ((count + threads - 1) / threads + 7) / 8 * 8;
+    }
+
+    void scale_or_clear(double *y, double beta, size_t n) {
+        if (beta == 0.0) {
+            std::fill(y, y + n, 0.0);
+        } else if (beta != 1.0) {
+            detail::scale(y, beta, y, n);
+        }
+    }
+
+}  // namespace
+
+void detail::gemv(size_t m, size_t n,
+                  double alpha, const double *a, size_t lda,
+                  const double *x, double beta, double *y) {
+    parallel_ranges(m, range_length(m), m * n, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            double dot = detail::dot(a + i * lda, x, n);
+            y[i] = beta == 0.0 ? alpha * dot : alpha * dot + beta * y[i];
+        }
+    });
+}
+
+void detail::gemv_transposed(size_t m, size_t n,
+                             double alpha, const double *a, size_t lda,
+                             const double *x, double beta, double *y) {
+    // Each range owns a slice of y and accumulates the matching slice of every row into it.
+    parallel_ranges(n, range_length(n), m * n, [&](size_t, size_t begin, size_t end) {
+        scale_or_clear(y + begin, beta, end - begin);
+        for (size_t i = 0; i < m; i++) {
+            detail::axpy(alpha * x[i], a + i * lda + begin, y + begin, end - begin);
+        }
+    });
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace task {
+
+    namespace detail {
+
+        // y = alpha * A * x + beta * y for row-major A (m x n). With beta == 0, y is
+        // overwritten without being read.
+        void gemv(size_t m, size_t n,
+                  double alpha, const double *a, size_t lda,
+                  const double *x, double beta, double *y);
+
+        // y = alpha * A^T * x + beta * y for the same row-major A (m x n): x has m entries
+        // and y has n. A is still streamed row by row.
+        void gemv_transposed(size_t m, size_t n,
+                             double alpha, const double *a, size_t lda,
+                             const double *x, double beta, double *y);
+
+    }  // namespace detail
+
+}  // namespace task
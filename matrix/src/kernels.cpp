@@ -0,0 +1,952 @@
+#include "kernels.h"
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MATRIX_X86_KERNELS
+#endif
+
+using namespace task;
+
+namespace {
+
+    struct Reductions {
+        double (*sum)(const double *, size_t);
+        double (*sum_kahan)(const double *, size_t);
+        double (*sum_abs)(const double *, size_t);
+        double (*sum_squares)(const double *, size_t);
+        double (*min)(const double *, size_t);
+        double (*max)(const double *, size_t);
+        double (*max_abs)(const double *, size_t);
+    };
+
+    struct Comparisons {
+        size_t (*absolute)(const double *, const double *, size_t, double, double *, bool);
+        size_t (*relative)(const double *, const double *, size_t, double, double *, bool);
+        size_t (*ulp)(const double *, const double *, size_t, double, double *, bool);
+    };
+
+    struct Kernels {
+        void (*add)(const double *, const double *, double *, size_t);
+        void (*subtract)(const double *, const double *, double *, size_t);
+        void (*scale)(const double *, double, double *, size_t);
+        double (*dot)(const double *, const double *, size_t);
+        void (*axpy)(double, const double *, double *, size_t);
+        void (*add_abs)(const double *, double *, size_t);
+        Reductions reductions;
+        Comparisons comparisons;
+        void (*add_float)(const float *, const float *, float *, size_t);
+        void (*subtract_float)(const float *, const float *, float *, size_t);
+        void (*scale_float)(const float *, float, float *, size_t);
+        const char *name;
+    };
+
+    template<class T>
+    void add_scalar(const T *a, const T *b, T *out, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = a[i] + b[i];
+        }
+    }
+
+    template<class T>
+    void subtract_scalar(const T *a, const T *b, T *out, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = a[i] - b[i];
+        }
+    }
+
+    template<class T>
+    void scale_scalar(const T *a, T factor, T *out, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = factor * a[i];
+        }
+    }
+
+    template<class T>
+    T dot_scalar(const T *a, const T *b, size_t n) {
+        T sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    template<class T>
+    void axpy_scalar(T alpha, const T *x, T *y, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    void add_abs_scalar(const double *x, double *y, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            y[i] += std::fabs(x[i]);
+        }
+    }
+
+    // Reductions are written once over LANES independent accumulators, which the compiler
+    // keeps in vector registers without reassociating anything; the target-specific
+    // wrappers below only pick the width and the instruction set they are compiled for.
+    template<size_t LANES, class Map>
+    __attribute__((always_inline)) inline double sum_lanes(const double *a, size_t n, Map map) {
+        double acc[LANES] = {};
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            for (size_t l = 0; l < LANES; l++) {
+                acc[l] += map(a[i + l]);
+            }
+        }
+        for (size_t l = 0; i < n; i++, l++) {
+            acc[l] += map(a[i]);
+        }
+        for (size_t width = LANES / 2; width > 0; width /= 2) {
+            for (size_t l = 0; l < width; l++) {
+                acc[l] += acc[l + width];
+            }
+        }
+        return acc[0];
+    }
+
+    // GCC vector types of LANES doubles (and same-sized integers), lowered to whatever
+    // registers the enclosing function's target provides.
+    template<size_t LANES>
+    struct LaneVector;
+
+    template<>
+    struct LaneVector<2> {
+        typedef double type __attribute__((vector_size(2 * sizeof(double))));
+        typedef int64_t integers __attribute__((vector_size(2 * sizeof(int64_t))));
+        typedef uint64_t naturals __attribute__((vector_size(2 * sizeof(uint64_t))));
+    };
+
+    template<>
+    struct LaneVector<4> {
+        typedef double type __attribute__((vector_size(4 * sizeof(double))));
+        typedef int64_t integers __attribute__((vector_size(4 * sizeof(int64_t))));
+        typedef uint64_t naturals __attribute__((vector_size(4 * sizeof(uint64_t))));
+    };
+
+    template<>
+    struct LaneVector<8> {
+        typedef double type __attribute__((vector_size(8 * sizeof(double))));
+        typedef int64_t integers __attribute__((vector_size(8 * sizeof(int64_t))));
+        typedef uint64_t naturals __attribute__((vector_size(8 * sizeof(uint64_t))));
+    };
+
+    template<>
+    struct LaneVector<16> {
+        typedef double type __attribute__((vector_size(16 * sizeof(double))));
+        typedef int64_t integers __attribute__((vector_size(16 * sizeof(int64_t))));
+        typedef uint64_t naturals __attribute__((vector_size(16 * sizeof(uint64_t))));
+    };
+
+    // The compensation update reuses every partial sum twice, which the loop vectorizer
+    // refuses to treat as a reduction, so the lanes are spelled as one vector value.
+    template<size_t LANES>
+    __attribute__((always_inline)) inline double sum_kahan_lanes(const double *a, size_t n) {
+        typedef typename LaneVector<LANES>::type Lanes;
+        Lanes sum = {};
+        Lanes compensation = {};
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            Lanes value;
+            std::memcpy(&value, a + i, sizeof(value));
+            Lanes y = value - compensation;
+            Lanes t = sum + y;
+            compensation = (t - sum) - y;
+            sum = t;
+        }
+
+        double total = 0.0;
+        double correction = 0.0;
+        auto add = [&](double value) {
+            double y = value - correction;
+            double t = total + y;
+            correction = (t - total) - y;
+            total = t;
+        };
+        for (size_t l = 0; l < LANES; l++) {
+            add(sum[l]);
+            add(-compensation[l]);
+        }
+        for (; i < n; i++) {
+            add(a[i]);
+        }
+        return total;
+    }
+
+    template<size_t LANES, class Pick>
+    __attribute__((always_inline)) inline double select_lanes(const double *a, size_t n, double initial, Pick pick) {
+        double acc[LANES];
+        for (size_t l = 0; l < LANES; l++) {
+            acc[l] = initial;
+        }
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            for (size_t l = 0; l < LANES; l++) {
+                acc[l] = pick(a[i + l], acc[l]);
+            }
+        }
+        for (; i < n; i++) {
+            acc[0] = pick(a[i], acc[0]);
+        }
+        for (size_t l = 1; l < LANES; l++) {
+            acc[0] = pick(acc[l], acc[0]);
+        }
+        return acc[0];
+    }
+
+    inline double identity(double x) {
+        return x;
+    }
+
+    inline double absolute(double x) {
+        return x < 0 ? -x : x;
+    }
+
+    inline double square(double x) {
+        return x * x;
+    }
+
+    inline double smaller(double x, double y) {
+        return x < y ? x : y;
+    }
+
+    inline double larger(double x, double y) {
+        return x > y ? x : y;
+    }
+
+    // Unlike larger(), a NaN in either argument wins.
+    inline double larger_abs(double x, double y) {
+        return y != y || absolute(x) <= y ? y : absolute(x);
+    }
+
+    template<size_t LANES>
+    double sum_generic(const double *a, size_t n) {
+        return sum_lanes<LANES>(a, n, identity);
+    }
+
+    template<size_t LANES>
+    double sum_kahan_generic(const double *a, size_t n) {
+        return sum_kahan_lanes<LANES>(a, n);
+    }
+
+    template<size_t LANES>
+    double sum_abs_generic(const double *a, size_t n) {
+        return sum_lanes<LANES>(a, n, absolute);
+    }
+
+    template<size_t LANES>
+    double sum_squares_generic(const double *a, size_t n) {
+        return sum_lanes<LANES>(a, n, square);
+    }
+
+    template<size_t LANES>
+    double min_generic(const double *a, size_t n) {
+        return select_lanes<LANES>(a, n, HUGE_VAL, smaller);
+    }
+
+    template<size_t LANES>
+    double max_generic(const double *a, size_t n) {
+        return select_lanes<LANES>(a, n, -HUGE_VAL, larger);
+    }
+
+    template<size_t LANES>
+    double max_abs_generic(const double *a, size_t n) {
+        return select_lanes<LANES>(a, n, 0.0, larger_abs);
+    }
+
+    template<size_t LANES>
+    Reductions generic_reductions() {
+        return {sum_generic<LANES>, sum_kahan_generic<LANES>, sum_abs_generic<LANES>, sum_squares_generic<LANES>,
+                min_generic<LANES>, max_generic<LANES>, max_abs_generic<LANES>};
+    }
+
+    // Deviations are computed a whole LaneVector at a time from lanes x and y of the two
+    // inputs. Vectors are passed by reference to keep them out of the calling convention.
+    struct AbsoluteDeviation {
+        template<class V>
+        __attribute__((always_inline)) void operator()(const V &x, const V &y, V &out) const {
+            V d = x - y;
+            d = d < 0 ? -d : d;
+            d = d == d ? d : HUGE_VAL;
+            out = x == y ? 0.0 : d;
+        }
+    };
+
+    struct RelativeDeviation {
+        template<class V>
+        __attribute__((always_inline)) void operator()(const V &x, const V &y, V &out) const {
+            V d = x - y;
+            d = d < 0 ? -d : d;
+            V x_abs = x < 0 ? -x : x;
+            V y_abs = y < 0 ? -y : y;
+            d /= x_abs > y_abs ? x_abs : y_abs;
+            d = d == d ? d : HUGE_VAL;
+            out = x == y ? 0.0 : d;
+        }
+    };
+
+    // Maps each double to an integer whose order matches the numeric order, with +0 and -0
+    // both at 0, so the distance between two mapped values counts the doubles between them.
+    template<size_t LANES>
+    struct UlpDeviation {
+        typedef typename LaneVector<LANES>::integers I;
+        typedef typename LaneVector<LANES>::naturals U;
+        typedef typename LaneVector<LANES>::type V;
+
+        __attribute__((always_inline)) void operator()(const V &x, const V &y, V &out) const {
+            // Both arms of a vector ?: are evaluated, so the mapping is done in unsigned
+            // arithmetic, where INT64_MIN - bits on a positive lane cannot overflow.
+            const uint64_t sign = uint64_t(1) << 63;
+            U a = (U) x;
+            U b = (U) y;
+            a = (I) a < 0 ? sign - a : a;
+            b = (I) b < 0 ? sign - b : b;
+            U d = (I) a > (I) b ? a - b : b - a;
+            out = (x != x) | (y != y) ? HUGE_VAL : __builtin_convertvector(d, V);
+        }
+    };
+
+    // LANES must match the register width: GCC splits wider vector conditionals into scalars.
+    // Takes the largest deviation of each block of 8 * LANES elements in vector registers and
+    // only scans the stored deviations of a block that breaks the tolerance. Equal values are 0
+    // apart and a NaN is infinitely far from everything, so a NaN always counts as a mismatch.
+    template<size_t LANES, class Deviation>
+    __attribute__((always_inline)) inline size_t mismatch_lanes(const double *a, const double *b, size_t n,
+                                                                double tolerance, double *max_deviation,
+                                                                bool stop, Deviation deviation) {
+        typedef typename LaneVector<LANES>::type Lanes;
+        const size_t BLOCK = 8 * LANES;
+
+        double largest = *max_deviation;
+        size_t first = n;
+        for (size_t start = 0; start < n; start += BLOCK) {
+            size_t length = std::min(BLOCK, n - start);
+            double deviations[BLOCK];
+            Lanes peak = {};
+            for (size_t i = 0; i < length; i += LANES) {
+                Lanes x = {};
+                Lanes y = {};
+                if (i + LANES <= length) {
+                    std::memcpy(&x, a + start + i, sizeof(x));
+                    std::memcpy(&y, b + start + i, sizeof(y));
+                } else {
+                    for (size_t l = 0; i + l < length; l++) {
+                        x[l] = a[start + i + l];
+                        y[l] = b[start + i + l];
+                    }
+                }
+                Lanes d;
+                deviation(x, y, d);
+                peak = d > peak ? d : peak;
+                std::memcpy(deviations + i, &d, sizeof(d));
+            }
+            double block_peak = 0.0;
+            for (size_t l = 0; l < LANES; l++) {
+                block_peak = larger(peak[l], block_peak);
+            }
+
+            if (block_peak > tolerance && first == n) {
+                size_t i = 0;
+                for (; deviations[i] <= tolerance; i++) {
+                    largest = larger(deviations[i], largest);
+                }
+                first = start + i;
+                if (stop) {
+                    *max_deviation = larger(deviations[i], largest);
+                    return first;
+                }
+            }
+            largest = larger(block_peak, largest);
+        }
+        *max_deviation = largest;
+        return first;
+    }
+
+    template<size_t LANES>
+    size_t mismatch_absolute_generic(const double *a, const double *b, size_t n, double tolerance,
+                                     double *max_deviation, bool stop) {
+        return mismatch_lanes<LANES>(a, b, n, tolerance, max_deviation, stop, AbsoluteDeviation());
+    }
+
+    template<size_t LANES>
+    size_t mismatch_relative_generic(const double *a, const double *b, size_t n, double tolerance,
+                                     double *max_deviation, bool stop) {
+        return mismatch_lanes<LANES>(a, b, n, tolerance, max_deviation, stop, RelativeDeviation());
+    }
+
+    template<size_t LANES>
+    size_t mismatch_ulp_generic(const double *a, const double *b, size_t n, double tolerance,
+                                double *max_deviation, bool stop) {
+        return mismatch_lanes<LANES>(a, b, n, tolerance, max_deviation, stop, UlpDeviation<LANES>());
+    }
+
+    template<size_t LANES>
+    Comparisons generic_comparisons() {
+        return {mismatch_absolute_generic<LANES>, mismatch_relative_generic<LANES>, mismatch_ulp_generic<LANES>};
+    }
+
+#ifdef MATRIX_X86_KERNELS
+
+    void add_sse2(const double *a, const double *b, double *out, size_t n) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        }
+        add_scalar(a + i, b + i, out + i, n - i);
+    }
+
+    void subtract_sse2(const double *a, const double *b, double *out, size_t n) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(out + i, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        }
+        subtract_scalar(a + i, b + i, out + i, n - i);
+    }
+
+    void scale_sse2(const double *a, double factor, double *out, size_t n) {
+        __m128d f = _mm_set1_pd(factor);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(out + i, _mm_mul_pd(f, _mm_loadu_pd(a + i)));
+        }
+        scale_scalar(a + i, factor, out + i, n - i);
+    }
+
+    // Dot products keep several independent accumulators to hide the add latency.
+    double dot_sse2(const double *a, const double *b, size_t n) {
+        __m128d s0 = _mm_setzero_pd();
+        __m128d s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+        }
+        s0 = _mm_add_pd(s0, s1);
+        double sum = _mm_cvtsd_f64(_mm_add_sd(s0, _mm_unpackhi_pd(s0, s0)));
+        return sum + dot_scalar(a + i, b + i, n - i);
+    }
+
+    void axpy_sse2(double alpha, const double *x, double *y, size_t n) {
+        __m128d f = _mm_set1_pd(alpha);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(f, _mm_loadu_pd(x + i))));
+        }
+        axpy_scalar(alpha, x + i, y + i, n - i);
+    }
+
+    void add_abs_sse2(const double *x, double *y, size_t n) {
+        __m128d magnitude = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffff));
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_and_pd(magnitude, _mm_loadu_pd(x + i))));
+        }
+        add_abs_scalar(x + i, y + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void add_avx2(const double *a, const double *b, double *out, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d x0 = _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+            __m256d x1 = _mm256_add_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+            _mm256_storeu_pd(out + i, x0);
+            _mm256_storeu_pd(out + i + 4, x1);
+        }
+        add_sse2(a + i, b + i, out + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void subtract_avx2(const double *a, const double *b, double *out, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d x0 = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+            __m256d x1 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+            _mm256_storeu_pd(out + i, x0);
+            _mm256_storeu_pd(out + i + 4, x1);
+        }
+        subtract_sse2(a + i, b + i, out + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void scale_avx2(const double *a, double factor, double *out, size_t n) {
+        __m256d f = _mm256_set1_pd(factor);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d x0 = _mm256_mul_pd(f, _mm256_loadu_pd(a + i));
+            __m256d x1 = _mm256_mul_pd(f, _mm256_loadu_pd(a + i + 4));
+            _mm256_storeu_pd(out + i, x0);
+            _mm256_storeu_pd(out + i + 4, x1);
+        }
+        scale_sse2(a + i, factor, out + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    double dot_avx2(const double *a, const double *b, size_t n) {
+        __m256d s0 = _mm256_setzero_pd();
+        __m256d s1 = _mm256_setzero_pd();
+        __m256d s2 = _mm256_setzero_pd();
+        __m256d s3 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+            s2 = _mm256_add_pd(s2, _mm256_mul_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8)));
+            s3 = _mm256_add_pd(s3, _mm256_mul_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12)));
+        }
+        __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+        double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+        return sum + dot_sse2(a + i, b + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void axpy_avx2(double alpha, const double *x, double *y, size_t n) {
+        __m256d f = _mm256_set1_pd(alpha);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d y0 = _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_mul_pd(f, _mm256_loadu_pd(x + i)));
+            __m256d y1 = _mm256_add_pd(_mm256_loadu_pd(y + i + 4), _mm256_mul_pd(f, _mm256_loadu_pd(x + i + 4)));
+            _mm256_storeu_pd(y + i, y0);
+            _mm256_storeu_pd(y + i + 4, y1);
+        }
+        axpy_sse2(alpha, x + i, y + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void add_abs_avx2(const double *x, double *y, size_t n) {
+        __m256d magnitude = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d x0 = _mm256_and_pd(magnitude, _mm256_loadu_pd(x + i));
+            __m256d x1 = _mm256_and_pd(magnitude, _mm256_loadu_pd(x + i + 4));
+            _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), x0));
+            _mm256_storeu_pd(y + i + 4, _mm256_add_pd(_mm256_loadu_pd(y + i + 4), x1));
+        }
+        add_abs_sse2(x + i, y + i, n - i);
+    }
+
+    // AVX-512 handles the tail with a masked load/store instead of a scalar loop.
+    __attribute__((target("avx512f")))
+    void add_avx512(const double *a, const double *b, double *out, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+        }
+        if (i < n) {
+            __mmask8 mask = (__mmask8) ((1u << (n - i)) - 1);
+            __m512d x = _mm512_add_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i));
+            _mm512_mask_storeu_pd(out + i, mask, x);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void subtract_avx512(const double *a, const double *b, double *out, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+        }
+        if (i < n) {
+            __mmask8 mask = (__mmask8) ((1u << (n - i)) - 1);
+            __m512d x = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i));
+            _mm512_mask_storeu_pd(out + i, mask, x);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void scale_avx512(const double *a, double factor, double *out, size_t n) {
+        __m512d f = _mm512_set1_pd(factor);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm512_storeu_pd(out + i, _mm512_mul_pd(f, _mm512_loadu_pd(a + i)));
+        }
+        if (i < n) {
+            __mmask8 mask = (__mmask8) ((1u << (n - i)) - 1);
+            _mm512_mask_storeu_pd(out + i, mask, _mm512_mul_pd(f, _mm512_maskz_loadu_pd(mask, a + i)));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    double dot_avx512(const double *a, const double *b, size_t n) {
+        __m512d s0 = _mm512_setzero_pd();
+        __m512d s1 = _mm512_setzero_pd();
+        __m512d s2 = _mm512_setzero_pd();
+        __m512d s3 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+            s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), s1);
+            s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), s2);
+            s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), s3);
+        }
+        for (; i + 8 <= n; i += 8) {
+            s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+        }
+        if (i < n) {
+            __mmask8 mask = (__mmask8) ((1u << (n - i)) - 1);
+            s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i), s1);
+        }
+        // Reduced by hand: in GCC 12, _mm512_reduce_add_pd and the unmasked 256-bit extracts
+        // trip -Wuninitialized inside avx512fintrin.h, the masked extracts do not.
+        __m512d s = _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3));
+        __m256d low = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, s, 0);
+        __m256d high = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, s, 1);
+        __m256d folded = _mm256_add_pd(low, high);
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(folded), _mm256_extractf128_pd(folded, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    }
+
+    __attribute__((target("avx512f")))
+    void axpy_avx512(double alpha, const double *x, double *y, size_t n) {
+        __m512d f = _mm512_set1_pd(alpha);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm512_storeu_pd(y + i, _mm512_fmadd_pd(f, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        }
+        if (i < n) {
+            __mmask8 mask = (__mmask8) ((1u << (n - i)) - 1);
+            __m512d result = _mm512_fmadd_pd(f, _mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+            _mm512_mask_storeu_pd(y + i, mask, result);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void add_abs_avx512(const double *x, double *y, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm512_storeu_pd(y + i, _mm512_add_pd(_mm512_loadu_pd(y + i), _mm512_abs_pd(_mm512_loadu_pd(x + i))));
+        }
+        if (i < n) {
+            __mmask8 mask = (__mmask8) ((1u << (n - i)) - 1);
+            __m512d result = _mm512_add_pd(_mm512_maskz_loadu_pd(mask, y + i),
+                                           _mm512_abs_pd(_mm512_maskz_loadu_pd(mask, x + i)));
+            _mm512_mask_storeu_pd(y + i, mask, result);
+        }
+    }
+
+    // Two registers' worth of lanes per reduction at each vector width.
+
+    __attribute__((target("avx2")))
+    double sum_avx2(const double *a, size_t n) {
+        return sum_lanes<8>(a, n, identity);
+    }
+
+    __attribute__((target("avx2")))
+    double sum_kahan_avx2(const double *a, size_t n) {
+        return sum_kahan_lanes<8>(a, n);
+    }
+
+    __attribute__((target("avx2")))
+    double sum_abs_avx2(const double *a, size_t n) {
+        return sum_lanes<8>(a, n, absolute);
+    }
+
+    __attribute__((target("avx2")))
+    double sum_squares_avx2(const double *a, size_t n) {
+        return sum_lanes<8>(a, n, square);
+    }
+
+    __attribute__((target("avx2")))
+    double min_avx2(const double *a, size_t n) {
+        return select_lanes<8>(a, n, HUGE_VAL, smaller);
+    }
+
+    __attribute__((target("avx2")))
+    double max_avx2(const double *a, size_t n) {
+        return select_lanes<8>(a, n, -HUGE_VAL, larger);
+    }
+
+    __attribute__((target("avx2")))
+    double max_abs_avx2(const double *a, size_t n) {
+        return select_lanes<8>(a, n, 0.0, larger_abs);
+    }
+
+    __attribute__((target("avx512f")))
+    double sum_avx512(const double *a, size_t n) {
+        return sum_lanes<16>(a, n, identity);
+    }
+
+    __attribute__((target("avx512f")))
+    double sum_kahan_avx512(const double *a, size_t n) {
+        return sum_kahan_lanes<16>(a, n);
+    }
+
+    __attribute__((target("avx512f")))
+    double sum_abs_avx512(const double *a, size_t n) {
+        return sum_lanes<16>(a, n, absolute);
+    }
+
+    __attribute__((target("avx512f")))
+    double sum_squares_avx512(const double *a, size_t n) {
+        return sum_lanes<16>(a, n, square);
+    }
+
+    __attribute__((target("avx512f")))
+    double min_avx512(const double *a, size_t n) {
+        return select_lanes<16>(a, n, HUGE_VAL, smaller);
+    }
+
+    __attribute__((target("avx512f")))
+    double max_avx512(const double *a, size_t n) {
+        return select_lanes<16>(a, n, -HUGE_VAL, larger);
+    }
+
+    __attribute__((target("avx512f")))
+    double max_abs_avx512(const double *a, size_t n) {
+        return select_lanes<16>(a, n, 0.0, larger_abs);
+    }
+
+    __attribute__((target("avx2")))
+    size_t mismatch_absolute_avx2(const double *a, const double *b, size_t n, double tolerance,
+                                  double *max_deviation, bool stop) {
+        return mismatch_lanes<4>(a, b, n, tolerance, max_deviation, stop, AbsoluteDeviation());
+    }
+
+    __attribute__((target("avx2")))
+    size_t mismatch_relative_avx2(const double *a, const double *b, size_t n, double tolerance,
+                                  double *max_deviation, bool stop) {
+        return mismatch_lanes<4>(a, b, n, tolerance, max_deviation, stop, RelativeDeviation());
+    }
+
+    __attribute__((target("avx2")))
+    size_t mismatch_ulp_avx2(const double *a, const double *b, size_t n, double tolerance,
+                             double *max_deviation, bool stop) {
+        return mismatch_lanes<4>(a, b, n, tolerance, max_deviation, stop, UlpDeviation<4>());
+    }
+
+    __attribute__((target("avx512f")))
+    size_t mismatch_absolute_avx512(const double *a, const double *b, size_t n, double tolerance,
+                                    double *max_deviation, bool stop) {
+        return mismatch_lanes<8>(a, b, n, tolerance, max_deviation, stop, AbsoluteDeviation());
+    }
+
+    __attribute__((target("avx512f")))
+    size_t mismatch_relative_avx512(const double *a, const double *b, size_t n, double tolerance,
+                                    double *max_deviation, bool stop) {
+        return mismatch_lanes<8>(a, b, n, tolerance, max_deviation, stop, RelativeDeviation());
+    }
+
+    __attribute__((target("avx512f")))
+    size_t mismatch_ulp_avx512(const double *a, const double *b, size_t n, double tolerance,
+                               double *max_deviation, bool stop) {
+        return mismatch_lanes<8>(a, b, n, tolerance, max_deviation, stop, UlpDeviation<8>());
+    }
+
+    // Single precision: same structure, twice the lanes per register.
+
+    void add_float_sse2(const float *a, const float *b, float *out, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        add_scalar(a + i, b + i, out + i, n - i);
+    }
+
+    void subtract_float_sse2(const float *a, const float *b, float *out, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        subtract_scalar(a + i, b + i, out + i, n - i);
+    }
+
+    void scale_float_sse2(const float *a, float factor, float *out, size_t n) {
+        __m128 f = _mm_set1_ps(factor);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(out + i, _mm_mul_ps(f, _mm_loadu_ps(a + i)));
+        }
+        scale_scalar(a + i, factor, out + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void add_float_avx2(const float *a, const float *b, float *out, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+        add_float_sse2(a + i, b + i, out + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void subtract_float_avx2(const float *a, const float *b, float *out, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+        subtract_float_sse2(a + i, b + i, out + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void scale_float_avx2(const float *a, float factor, float *out, size_t n) {
+        __m256 f = _mm256_set1_ps(factor);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(f, _mm256_loadu_ps(a + i)));
+        }
+        scale_float_sse2(a + i, factor, out + i, n - i);
+    }
+
+    __attribute__((target("avx512f")))
+    void add_float_avx512(const float *a, const float *b, float *out, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+        }
+        if (i < n) {
+            __mmask16 mask = (__mmask16) ((1u << (n - i)) - 1);
+            __m512 x = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+            _mm512_mask_storeu_ps(out + i, mask, x);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void subtract_float_avx512(const float *a, const float *b, float *out, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            _mm512_storeu_ps(out + i, _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+        }
+        if (i < n) {
+            __mmask16 mask = (__mmask16) ((1u << (n - i)) - 1);
+            __m512 x = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+            _mm512_mask_storeu_ps(out + i, mask, x);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void scale_float_avx512(const float *a, float factor, float *out, size_t n) {
+        __m512 f = _mm512_set1_ps(factor);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            _mm512_storeu_ps(out + i, _mm512_mul_ps(f, _mm512_loadu_ps(a + i)));
+        }
+        if (i < n) {
+            __mmask16 mask = (__mmask16) ((1u << (n - i)) - 1);
+            _mm512_mask_storeu_ps(out + i, mask, _mm512_mul_ps(f, _mm512_maskz_loadu_ps(mask, a + i)));
+        }
+    }
+
+#endif
+
+    Kernels select_kernels() {
+#ifdef MATRIX_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return {add_avx512, subtract_avx512, scale_avx512, dot_avx512, axpy_avx512, add_abs_avx512,
+                    {sum_avx512, sum_kahan_avx512, sum_abs_avx512, sum_squares_avx512,
+                     min_avx512, max_avx512, max_abs_avx512},
+                    {mismatch_absolute_avx512, mismatch_relative_avx512, mismatch_ulp_avx512},
+                    add_float_avx512, subtract_float_avx512, scale_float_avx512, "avx512"};
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return {add_avx2, subtract_avx2, scale_avx2, dot_avx2, axpy_avx2, add_abs_avx2,
+                    {sum_avx2, sum_kahan_avx2, sum_abs_avx2, sum_squares_avx2,
+                     min_avx2, max_avx2, max_abs_avx2},
+                    {mismatch_absolute_avx2, mismatch_relative_avx2, mismatch_ulp_avx2},
+                    add_float_avx2, subtract_float_avx2, scale_float_avx2, "avx2"};
+        }
+        return {add_sse2, subtract_sse2, scale_sse2, dot_sse2, axpy_sse2, add_abs_sse2,
+                generic_reductions<4>(), generic_comparisons<2>(),
+                add_float_sse2, subtract_float_sse2, scale_float_sse2, "sse2"};
+#else
+        return {add_scalar<double>, subtract_scalar<double>, scale_scalar<double>,
+                dot_scalar<double>, axpy_scalar<double>, add_abs_scalar,
+                generic_reductions<4>(), generic_comparisons<2>(),
+                add_scalar<float>, subtract_scalar<float>, scale_scalar<float>, "scalar"};
+#endif
+    }
+
+    const Kernels &kernels() {
+        static const Kernels selected = select_kernels();
+        return selected;
+    }
+
+}  // namespace
+
+void detail::add(const double *a, const double *b, double *out, size_t n) {
+    kernels().add(a, b, out, n);
+}
+
+void detail::subtract(const double *a, const double *b, double *out, size_t n) {
+    kernels().subtract(a, b, out, n);
+}
+
+void detail::scale(const double *a, double factor, double *out, size_t n) {
+    kernels().scale(a, factor, out, n);
+}
+
+double detail::dot(const double *a, const double *b, size_t n) {
+    return kernels().dot(a, b, n);
+}
+
+void detail::axpy(double alpha, const double *x, double *y, size_t n) {
+    kernels().axpy(alpha, x, y, n);
+}
+
+void detail::add_abs(const double *x, double *y, size_t n) {
+    kernels().add_abs(x, y, n);
+}
+
+double detail::sum(const double *a, size_t n) {
+    return kernels().reductions.sum(a, n);
+}
+
+double detail::sum_kahan(const double *a, size_t n) {
+    return kernels().reductions.sum_kahan(a, n);
+}
+
+double detail::sum_abs(const double *a, size_t n) {
+    return kernels().reductions.sum_abs(a, n);
+}
+
+double detail::sum_squares(const double *a, size_t n) {
+    return kernels().reductions.sum_squares(a, n);
+}
+
+double detail::min(const double *a, size_t n) {
+    return kernels().reductions.min(a, n);
+}
+
+double detail::max(const double *a, size_t n) {
+    return kernels().reductions.max(a, n);
+}
+
+double detail::max_abs(const double *a, size_t n) {
+    return kernels().reductions.max_abs(a, n);
+}
+
+size_t detail::mismatch_absolute(const double *a, const double *b, size_t n, double tolerance,
+                                 double *max_deviation, bool stop) {
+    return kernels().comparisons.absolute(a, b, n, tolerance, max_deviation, stop);
+}
+
+size_t detail::mismatch_relative(const double *a, const double *b, size_t n, double tolerance,
+                                 double *max_deviation, bool stop) {
+    return kernels().comparisons.relative(a, b, n, tolerance, max_deviation, stop);
+}
+
+size_t detail::mismatch_ulp(const double *a, const double *b, size_t n, double tolerance,
+                            double *max_deviation, bool stop) {
+    return kernels().comparisons.ulp(a, b, n, tolerance, max_deviation, stop);
+}
+
+void detail::add(const float *a, const float *b, float *out, size_t n) {
+    kernels().add_float(a, b, out, n);
+}
+
+void detail::subtract(const float *a, const float *b, float *out, size_t n) {
+    kernels().subtract_float(a, b, out, n);
+}
+
+void detail::scale(const float *a, float factor, float *out, size_t n) {
+    kernels().scale_float(a, factor, out, n);
+}
+
+const char *detail::simd_level() {
+    return kernels().name;
+}
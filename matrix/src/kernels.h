@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace task {
+
+    namespace detail {
+
+        // Element-wise kernels over n contiguous doubles or floats. out may alias a (and b).
+        // The SSE2 / AVX2 / AVX-512 variant is picked once from cpuid.
+        void add(const double *a, const double *b, double *out, size_t n);
+
+        void subtract(const double *a, const double *b, double *out, size_t n);
+
+        void scale(const double *a, double factor, double *out, size_t n);
+
+        double dot(const double *a, const double *b, size_t n);
+
+        // y += alpha * x
+        void axpy(double alpha, const double *x, double *y, size_t n);
+
+        // y += |x|
+        void add_abs(const double *x, double *y, size_t n);
+
+        // Reductions over n contiguous doubles. sum_kahan carries a compensation term per
+        // SIMD lane; min / max skip NaN and return +inf / -inf for n == 0, max_abs returns
+        // NaN if there is one and 0 for n == 0.
+        double sum(const double *a, size_t n);
+
+        double sum_kahan(const double *a, size_t n);
+
+        double sum_abs(const double *a, size_t n);
+
+        double sum_squares(const double *a, size_t n);
+
+        double min(const double *a, size_t n);
+
+        double max(const double *a, size_t n);
+
+        double max_abs(const double *a, size_t n);
+
+        // Index of the first i whose deviation between a[i] and b[i] exceeds tolerance, or n if
+        // there is none. The deviation is |a - b|, |a - b| / max(|a|, |b|) or the distance in
+        // units in the last place; equal values (infinities too) are 0 apart and a NaN is
+        // infinitely far from everything. *max_deviation is raised to the largest deviation up
+        // to and including that index, or over all n elements when stop is false.
+        size_t mismatch_absolute(const double *a, const double *b, size_t n, double tolerance,
+                                 double *max_deviation, bool stop);
+
+        size_t mismatch_relative(const double *a, const double *b, size_t n, double tolerance,
+                                 double *max_deviation, bool stop);
+
+        size_t mismatch_ulp(const double *a, const double *b, size_t n, double tolerance,
+                            double *max_deviation, bool stop);
+
+        void add(const float *a, const float *b, float *out, size_t n);
+
+        void subtract(const float *a, const float *b, float *out, size_t n);
+
+        void scale(const float *a, float factor, float *out, size_t n);
+
+        // Name of the selected instruction set, for diagnostics.
+        const char *simd_level();
+
+    }  // namespace detail
+
+}  // namespace task
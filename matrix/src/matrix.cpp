@@ -1,12 +1,197 @@
 #include "matrix.h"
+#include "gemm.h"
+#include "gemv.h"
+#include "transpose.h"
+#include "factorization.h"
 #include <cmath>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <cstdio>
+#include <string>
+#include <limits>
+
+// The fast stream path reads the get area of a streambuf directly, downcasts std::cin's buffer
+// to libstdc++'s stdio_sync_filebuf to reach its FILE, locks that FILE with POSIX flockfile and
+// converts numbers with the floating-point std::to_chars / std::from_chars. Other toolchains, or
+// builds with MATRIX_PORTABLE_STREAMS defined, use the formatted stream operators instead.
+#if !defined(MATRIX_PORTABLE_STREAMS) && defined(__GLIBCXX__) && defined(__cpp_lib_to_chars) && \
+    (defined(__unix__) || defined(__APPLE__))
+#define MATRIX_STREAM_FAST_PATH
+#include <ext/stdio_sync_filebuf.h>
+#endif
 
 using namespace task;
 
+namespace {
+
+    thread_local std::pmr::memory_resource *current_resource = nullptr;
+
+    // Every buffer starts with its reference count; the header keeps the elements as aligned
+    // as new[] would.
+    const size_t HEADER = alignof(std::max_align_t);
+
+    static_assert(sizeof(std::atomic<size_t>) <= HEADER, "reference count must fit in the buffer header");
+
+    std::atomic<size_t> *references(double *data) {
+        return reinterpret_cast<std::atomic<size_t> *>(reinterpret_cast<char *>(data) - HEADER);
+    }
+
+}  // namespace
+
+std::pmr::memory_resource *task::getMatrixResource() {
+    return current_resource;
+}
+
+std::pmr::memory_resource *task::setMatrixResource(std::pmr::memory_resource *resource) {
+    std::pmr::memory_resource *previous = current_resource;
+    current_resource = resource;
+    return previous;
+}
+
+MatrixResourceScope::MatrixResourceScope(std::pmr::memory_resource *resource)
+        : previous(setMatrixResource(resource)) {
+}
+
+MatrixResourceScope::~MatrixResourceScope() {
+    setMatrixResource(this->previous);
+}
+
 void Matrix::allocate_memory() {
-    this->matrix = new double *[this->rows];
+    allocate_memory(this->rows, this->columns);
+}
+
+void Matrix::allocate_memory(size_t row_capacity, size_t stride) {
+    // Like new double[n], refuse sizes whose byte count does not fit in size_t. Nothing is
+    // changed until the allocation has succeeded.
+    if (stride != 0 && row_capacity > (SIZE_MAX - HEADER) / sizeof(double) / stride) {
+        throw std::bad_array_new_length();
+    }
+    size_t allocated = row_capacity * stride;
+
+    if (allocated <= INLINE_CAPACITY) {
+        this->stride = stride;
+        this->data = this->local;
+        this->allocated = INLINE_CAPACITY;
+        return;
+    }
+
+    size_t bytes = HEADER + allocated * sizeof(double);
+    void *buffer = this->resource ? this->resource->allocate(bytes, HEADER) : ::operator new(bytes);
+
+    new (buffer) std::atomic<size_t>(1);
+    this->stride = stride;
+    this->allocated = allocated;
+    this->data = reinterpret_cast<double *>(static_cast<char *>(buffer) + HEADER);
+}
+
+void Matrix::release_memory(double *buffer, size_t count) const {
+    if (buffer == nullptr || buffer == this->local) {
+        return;
+    }
+
+    std::atomic<size_t> *counter = references(buffer);
+    if (counter->fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    counter->~atomic();
+    if (this->resource) {
+        this->resource->deallocate(counter, HEADER + count * sizeof(double), HEADER);
+    } else {
+        ::operator delete(counter);
+    }
+}
+
+void Matrix::share(const Matrix &other) {
+    this->data = other.data;
+    this->stride = other.stride;
+    this->allocated = other.allocated;
+    references(this->data)->fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Matrix::shared() const {
+    return this->data && this->data != this->local && references(this->data)->load(std::memory_order_acquire) != 1;
+}
+
+void Matrix::detach() {
+    if (shared()) {
+        reallocate(row_capacity(), this->stride);
+    }
+}
+
+size_t Matrix::row_capacity() const {
+    return this->stride ? this->allocated / this->stride : SIZE_MAX;
+}
+
+void Matrix::reallocate(size_t row_capacity, size_t stride) {
+    // Inline elements are moved aside first: the new storage may be the same inline array.
+    double saved[INLINE_CAPACITY];
+    if (this->data == this->local) {
+        std::copy(this->local, this->local + this->allocated, saved);
+        this->data = saved;
+    }
+
+    double *old_data = this->data;
+    size_t old_allocated = this->allocated;
+    size_t old_stride = this->stride;
+
+    try {
+        allocate_memory(row_capacity, stride);
+    } catch (...) {
+        // The inline elements were only copied aside, so the matrix is unchanged.
+        if (old_data == saved) {
+            this->data = this->local;
+        }
+        throw;
+    }
+
+    size_t kept_rows = std::min(this->rows, row_capacity);
+    size_t kept_columns = std::min(this->columns, stride);
+    for (size_t i = 0; i < kept_rows; i++) {
+        std::memcpy(this->data + i * this->stride, old_data + i * old_stride, kept_columns * sizeof(double));
+    }
+
+    if (old_data != saved) {
+        release_memory(old_data, old_allocated);
+    }
+}
+
+void Matrix::take(Matrix &other) noexcept {
+    this->rows = other.rows;
+    this->columns = other.columns;
+    this->stride = other.stride;
+    this->allocated = other.allocated;
+    this->resource = other.resource;
+
+    if (other.data == other.local) {
+        std::copy(other.local, other.local + other.allocated, this->local);
+        this->data = this->local;
+    } else {
+        this->data = other.data;
+    }
+
+    other.data = nullptr;
+    other.rows = 0;
+    other.columns = 0;
+    other.stride = 0;
+    other.allocated = 0;
+}
+
+void Matrix::copy_from(const double *source, size_t source_stride) {
+    if (this->rows == 0 || this->columns == 0) {
+        return;
+    }
+    if (this->stride == source_stride) {
+        std::memcpy(this->data, source, this->rows * this->stride * sizeof(double));
+        return;
+    }
+
     for (size_t i = 0; i < this->rows; i++) {
-        this->matrix[i] = new double[this->columns];
+        std::memcpy(this->data + i * this->stride, source + i * source_stride, this->columns * sizeof(double));
     }
 }
 
@@ -22,224 +207,335 @@ void Matrix::check_size(size_t rows, size_t columns) const {
     }
 }
 
-Matrix::Matrix() {
-    this->rows = 1;
-    this->columns = 1;
-
-    allocate_memory();
-
-    this->matrix = new double *[rows];
-    this->matrix[0] = new double[columns];
+Matrix::Matrix() : Matrix(1, 1) {
+}
 
-    this->matrix[0][0] = 1.0;
+Matrix::Matrix(size_t rows, size_t columns) : Matrix(rows, columns, getMatrixResource()) {
 }
 
-Matrix::Matrix(size_t rows, size_t columns) {
+Matrix::Matrix(size_t rows, size_t columns, std::pmr::memory_resource *resource) : resource(resource) {
     this->rows = rows;
     this->columns = columns;
 
     allocate_memory();
 
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            this->matrix[i][j] = i == j ? 1.0 : 0.0;
-        }
+    std::fill(this->data, this->data + this->rows * this->stride, 0.0);
+    for (size_t i = 0; i < std::min(this->rows, this->columns); i++) {
+        this->data[i * this->stride + i] = 1.0;
     }
 }
 
-Matrix::Matrix(const Matrix &copy) {
+Matrix::Matrix(const Matrix &copy) : resource(getMatrixResource()) {
     this->rows = copy.rows;
     this->columns = copy.columns;
 
+    // Sharing across resources would let the copy outlive an arena it does not belong to.
+    if (copy.data && copy.data != copy.local && copy.resource == this->resource) {
+        share(copy);
+        return;
+    }
+
     allocate_memory();
+    copy_from(copy.data, copy.stride);
+}
 
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            this->matrix[i][j] = copy.matrix[i][j];
-        }
-    }
+Matrix::Matrix(Matrix &&other) noexcept {
+    take(other);
 }
 
 Matrix::~Matrix() {
-    for (size_t i = 0; i < this->columns; i++) {
-        delete[] this->matrix[i];
-    }
-    delete[] this->matrix;
+    release_memory(this->data, this->allocated);
 }
 
 Matrix &Matrix::operator=(const Matrix &copy) {
-    if (this == &copy) {
+    if (this == &copy || this->data == copy.data) {
+        return *this;
+    }
+
+    if (copy.data && copy.data != copy.local && copy.resource == this->resource) {
+        release_memory(this->data, this->allocated);
+
+        this->rows = copy.rows;
+        this->columns = copy.columns;
+        share(copy);
+
         return *this;
     }
 
-    if (this->rows != copy.rows || this->columns != copy.columns) {
-        this->~Matrix();
+    if (this->rows * this->columns != copy.rows * copy.columns || shared()) {
+        release_memory(this->data, this->allocated);
 
         this->rows = copy.rows;
         this->columns = copy.columns;
 
         allocate_memory();
+    } else {
+        this->rows = copy.rows;
+        this->columns = copy.columns;
+        this->stride = copy.columns;
     }
 
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            this->matrix[i][j] = copy.matrix[i][j];
-        }
+    copy_from(copy.data, copy.stride);
+
+    return *this;
+}
+
+Matrix &Matrix::operator=(Matrix &&other) {
+    if (this == &other) {
+        return *this;
     }
 
+    // A buffer from another resource may not outlive it (an arena scope can end before this
+    // matrix does), so it is copied rather than stolen.
+    if (other.data != other.local && other.resource != this->resource) {
+        return *this = static_cast<const Matrix &>(other);
+    }
+
+    if (this->data != this->local && other.data != other.local) {
+        std::swap(this->data, other.data);
+        std::swap(this->rows, other.rows);
+        std::swap(this->columns, other.columns);
+        std::swap(this->stride, other.stride);
+        std::swap(this->allocated, other.allocated);
+        return *this;
+    }
+
+    std::pmr::memory_resource *own = this->resource;
+    release_memory(this->data, this->allocated);
+    take(other);
+    this->resource = own;
+
     return *this;
 }
 
 double &Matrix::get(size_t row, size_t col) {
     check_bounds(row, col);
-    return this->matrix[row][col];
+    detach();
+    return this->data[row * this->stride + col];
 }
 
 const double &Matrix::get(size_t row, size_t col) const {
-    return get(row, col);
+    check_bounds(row, col);
+    return this->data[row * this->stride + col];
 }
 
 void Matrix::set(size_t row, size_t col, const double &value) {
     check_bounds(row, col);
-    this->matrix[row][col] = value;
+    detach();
+    this->data[row * this->stride + col] = value;
 }
 
 void Matrix::resize(size_t new_rows, size_t new_cols) {
-    Matrix new_matrix(new_rows, new_cols);
-
-    for (size_t i = 0; i < new_rows; i++) {
-        for (size_t j = 0; j < new_cols; j++) {
-            if (i < this->rows && j < this->columns) {
-                new_matrix.matrix[i][j] = this->matrix[i][j];
-            } else {
-                new_matrix.matrix[i][j] = 0.0;
-            }
+    // Reallocate only when the reservation is too small, and then grow the overflowing
+    // dimension geometrically so repeated growth stays amortized O(new elements).
+    size_t rows_available = row_capacity();
+    if (new_cols > this->stride || new_rows > rows_available || shared()) {
+        size_t new_stride = new_cols > this->stride ? std::max(new_cols, 2 * this->stride) : this->stride;
+        size_t new_row_capacity = new_rows > rows_available ? std::max(new_rows, 2 * rows_available)
+                                                            : std::max(new_rows, this->rows);
+        reallocate(new_row_capacity, new_stride);
+    }
+
+    size_t kept_rows = std::min(this->rows, new_rows);
+    if (new_cols > this->columns) {
+        for (size_t i = 0; i < kept_rows; i++) {
+            double *row = this->data + i * this->stride;
+            std::fill(row + this->columns, row + new_cols, 0.0);
         }
     }
-    *this = new_matrix;
+    for (size_t i = kept_rows; i < new_rows; i++) {
+        double *row = this->data + i * this->stride;
+        std::fill(row, row + new_cols, 0.0);
+    }
+
+    this->rows = new_rows;
+    this->columns = new_cols;
+}
+
+void Matrix::reserve(size_t rows, size_t cols) {
+    size_t rows_available = row_capacity();
+    if (cols > this->stride || rows > rows_available) {
+        reallocate(std::max(rows, this->rows), std::max(cols, this->stride));
+    }
+}
+
+size_t Matrix::capacity() const {
+    return this->allocated;
+}
+
+void Matrix::appendRow(const std::vector<double> &row) {
+    if (row.size() != this->columns) {
+        throw SizeMismatchException();
+    }
+
+    resize(this->rows + 1, this->columns);
+    std::copy(row.begin(), row.end(), this->data + (this->rows - 1) * this->stride);
+}
+
+void Matrix::appendColumn(const std::vector<double> &column) {
+    if (column.size() != this->rows) {
+        throw SizeMismatchException();
+    }
+
+    resize(this->rows, this->columns + 1);
+    for (size_t i = 0; i < this->rows; i++) {
+        this->data[i * this->stride + this->columns - 1] = column[i];
+    }
 }
 
 double *Matrix::operator[](size_t row) {
     check_bounds(row, 0);
-    return matrix[row];
+    detach();
+    return this->data + row * this->stride;
 }
 
 double const *Matrix::operator[](size_t row) const {
     check_bounds(row, 0);
-    return matrix[row];
+    return this->data + row * this->stride;
 }
 
-Matrix &Matrix::operator+=(const Matrix &a) {
-    check_size(a.rows, a.columns);
+void Matrix::combine(const Matrix &a, const Matrix &b,
+                     void (*kernel)(const double *, const double *, double *, size_t)) {
+    if (this->stride == this->columns && a.stride == a.columns && b.stride == b.columns) {
+        kernel(a.data, b.data, this->data, this->rows * this->columns);
+        return;
+    }
 
     for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            matrix[i][j] += a.matrix[i][j];
-        }
+        kernel(a.data + i * a.stride, b.data + i * b.stride, this->data + i * this->stride, this->columns);
     }
-
-    return *this;
 }
 
-Matrix &Matrix::operator-=(const Matrix &a) {
-    check_size(a.rows, a.columns);
+void Matrix::scale_from(const Matrix &a, double factor) {
+    if (this->stride == this->columns && a.stride == a.columns) {
+        detail::scale(a.data, factor, this->data, this->rows * this->columns);
+        return;
+    }
 
     for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            matrix[i][j] -= a.matrix[i][j];
-        }
+        detail::scale(a.data + i * a.stride, factor, this->data + i * this->stride, this->columns);
     }
+}
 
+Matrix &Matrix::operator+=(const Matrix &a) {
+    check_size(a.rows, a.columns);
+    detach();
+    combine(*this, a, detail::add);
     return *this;
 }
 
-Matrix &Matrix::operator*=(const Matrix &a) {
+Matrix &Matrix::operator-=(const Matrix &a) {
     check_size(a.rows, a.columns);
+    detach();
+    combine(*this, a, detail::subtract);
+    return *this;
+}
 
-    Matrix new_matrix(this->rows, a.columns);
-
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < a.columns; j++) {
-            new_matrix.matrix[i][j] = 0;
-
-            for (size_t k = 0; k < this->columns; k++) {
-                new_matrix.matrix[i][j] += matrix[i][k] * a.matrix[k][j];
-            }
-        }
-    }
-
-    *this = new_matrix;
+Matrix &Matrix::operator*=(const Matrix &a) {
+    *this = *this * a;
     return *this;
 }
 
 Matrix &Matrix::operator*=(const double &number) {
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            matrix[i][j] *= number;
-        }
-    }
+    detach();
+    scale_from(*this, number);
     return *this;
 }
 
-Matrix Matrix::operator+(const Matrix &a) const {
-    check_size(a.rows, a.columns);
+Matrix Matrix::operator*(const Matrix &a) const {
+    check_size(this->rows, a.rows);
 
-    Matrix new_matrix(*this);
-    new_matrix += a;
+    Matrix new_matrix(this->rows, a.columns);
+    detail::gemm(this->rows, a.columns, this->columns,
+                 1.0, this->data, this->stride,
+                 a.data, a.stride,
+                 0.0, new_matrix.data, new_matrix.stride);
 
     return new_matrix;
 }
 
-Matrix Matrix::operator-(const Matrix &a) const {
-    check_size(a.rows, a.columns);
+Matrix expr::multiply(const ConstMatrixView &left, const ConstMatrixView &right) {
+    if (left.getColumnsNum() != right.getRowsNum()) {
+        throw SizeMismatchException();
+    }
 
-    Matrix new_matrix(*this);
-    new_matrix -= a;
+    Matrix new_matrix(left.getRowsNum(), right.getColumnsNum());
+    detail::gemm(left.getRowsNum(), right.getColumnsNum(), left.getColumnsNum(),
+                 1.0, left.begin(), left.getRowStride(), left.getColumnStride(),
+                 right.begin(), right.getRowStride(), right.getColumnStride(),
+                 0.0, new_matrix.data, new_matrix.stride);
 
     return new_matrix;
 }
 
-Matrix Matrix::operator*(const Matrix &a) const {
-    check_size(this->rows, a.columns);
-
-    Matrix new_matrix(this->rows, a.columns);
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < a.columns; j++) {
-            new_matrix.matrix[i][j] = 0;
-            for (size_t s = 0; s < this->columns; s++) {
-                new_matrix.matrix[i][j] += this->matrix[i][s] * a.matrix[s][j];
-            }
-        }
-    }
+std::vector<double> Matrix::operator*(const std::vector<double> &vector) const {
+    std::vector<double> result(this->rows);
+    gemv(1.0, *this, vector, 0.0, result);
+    return result;
+}
 
-    return new_matrix;
+std::vector<double> task::operator*(const std::vector<double> &vector, const Matrix &matrix) {
+    std::vector<double> result(matrix.columns);
+    gemv(1.0, matrix, vector, 0.0, result, true);
+    return result;
 }
 
-Matrix Matrix::operator*(const double &a) const {
-    Matrix new_matrix(*this);
+void task::gemv(double alpha, const Matrix &a, const std::vector<double> &x,
+                double beta, std::vector<double> &y, bool transposed) {
+    size_t in = transposed ? a.rows : a.columns;
+    size_t out = transposed ? a.columns : a.rows;
+    if (x.size() != in || y.size() != out) {
+        throw SizeMismatchException();
+    }
 
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            new_matrix.matrix[i][j] *= a;
-        }
+    if (&x == &y) {
+        std::vector<double> copy(x);
+        gemv(alpha, a, copy, beta, y, transposed);
+        return;
     }
-    return new_matrix;
-}
 
-Matrix Matrix::operator-() const {
-    Matrix new_matrix(*this);
+    if (transposed) {
+        detail::gemv_transposed(a.rows, a.columns, alpha, a.data, a.stride, x.data(), beta, y.data());
+    } else {
+        detail::gemv(a.rows, a.columns, alpha, a.data, a.stride, x.data(), beta, y.data());
+    }
+}
 
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            new_matrix.matrix[i][j] *= -1;
+void task::gemm(double alpha, const Matrix &a, const Matrix &b, double beta, Matrix &c,
+                bool transpose_a, bool transpose_b) {
+    size_t m = transpose_a ? a.columns : a.rows;
+    size_t k = transpose_a ? a.rows : a.columns;
+    size_t n = transpose_b ? b.rows : b.columns;
+    if ((transpose_b ? b.columns : b.rows) != k) {
+        throw SizeMismatchException();
+    }
+    c.check_size(m, n);
+
+    if (&c == &a || &c == &b) {
+        Matrix product(m, n);
+        gemm(alpha, a, b, 0.0, product, transpose_a, transpose_b);
+        if (beta == 0.0) {
+            c = std::move(product);
+        } else {
+            c *= beta;
+            c += product;
         }
+        return;
     }
-    return new_matrix;
+    c.detach();
+
+    detail::gemm(m, n, k, alpha,
+                 a.data, transpose_a ? 1 : a.stride, transpose_a ? a.stride : 1,
+                 b.data, transpose_b ? 1 : b.stride, transpose_b ? b.stride : 1,
+                 beta, c.data, c.stride);
 }
 
-Matrix Matrix::operator+() const {
-    Matrix new_matrix(*this);
-    return new_matrix;
+Matrix Matrix::operator+() const & {
+    return *this;
+}
+
+Matrix Matrix::operator+() && {
+    return std::move(*this);
 }
 
 double Matrix::det() const {
@@ -247,55 +543,71 @@ double Matrix::det() const {
         throw SizeMismatchException();
     }
 
-    double det = 0;
+    size_t n = this->rows;
 
-    if (this->rows == 1) {
-        det = matrix[0][0];
-    } else if (this->rows == 2) {
-        det = matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
-    } else {
-        for (size_t k = 0; k < this->rows; k++) {
-            Matrix submatrix(this->rows - 1, this->rows - 1);
-
-            for (size_t i = 1; i < this->rows; i++) {
-                size_t l = 0;
-                for (size_t j = 0; j < this->rows; j++) {
-                    if (j == k) {
-                        continue;
-                    } else {
-                        submatrix.matrix[i - 1][l] = matrix[i][j];
-                        l++;
-                    }
-                }
-            }
-            det += std::pow(-1, k) * matrix[0][k] * submatrix.det();
+    if (n == 1) {
+        return data[0];
+    }
+    if (n == 2) {
+        return data[0] * data[stride + 1] - data[1] * data[stride];
+    }
+    // The remaining sizes that fit inline run the same elimination kernel as LUFactorization,
+    // on a stack copy, so they never allocate.
+    if (n * n <= INLINE_CAPACITY) {
+        double lu[INLINE_CAPACITY];
+        size_t pivots[INLINE_CAPACITY];
+        for (size_t i = 0; i < n; i++) {
+            std::copy(this->data + i * this->stride, this->data + i * this->stride + n, lu + i * n);
+        }
+
+        bool odd_permutation = false;
+        if (detail::lu_panel(n, lu, n, 0, n, pivots, odd_permutation)) {
+            return 0.0;
+        }
+
+        double result = odd_permutation ? -1.0 : 1.0;
+        for (size_t k = 0; k < n; k++) {
+            result *= lu[k * n + k];
         }
+        return result;
     }
 
-    return det;
+    // Blocked LU with partial pivoting: det = sign * prod(U[i][i]).
+    return LUFactorization(*this).det();
 }
 
 void Matrix::transpose() {
-    Matrix new_matrix(this->columns, this->rows);
+    detach();
+
+    if (this->rows == this->columns) {
+        detail::transpose_square(this->rows, this->data, this->stride);
+        return;
+    }
+
+    // Small rectangular matrices transpose out of place through a stack copy.
+    if (this->data == this->local) {
+        double saved[INLINE_CAPACITY];
+        std::copy(this->local, this->local + this->allocated, saved);
+        detail::transpose(this->rows, this->columns, saved, this->stride, this->local, this->rows);
+        std::swap(this->rows, this->columns);
+        this->stride = this->columns;
+        return;
+    }
 
-    for (size_t i = 0; i < this->columns; i++) {
-        for (size_t j = 0; j < this->rows; j++) {
-            new_matrix.matrix[i][j] = this->matrix[j][i];
+    if (this->stride != this->columns) {
+        for (size_t i = 1; i < this->rows; i++) {
+            std::memmove(this->data + i * this->columns, this->data + i * this->stride, this->columns * sizeof(double));
         }
     }
 
-    *this = new_matrix;
+    detail::transpose_dense(this->rows, this->columns, this->data);
+    std::swap(this->rows, this->columns);
+    this->stride = this->columns;
 }
 
 Matrix Matrix::transposed() const {
     Matrix new_matrix(this->columns, this->rows);
-
-    for (size_t i = 0; i < this->columns; i++) {
-        for (size_t j = 0; j < this->rows; j++) {
-            new_matrix.matrix[i][j] = matrix[j][i];
-        }
-    }
-
+    detail::transpose(this->rows, this->columns, this->data, this->stride, new_matrix.data, new_matrix.stride);
     return new_matrix;
 }
 
@@ -306,45 +618,236 @@ double Matrix::trace() const {
 
     double result = 0;
     for (size_t i = 0; i < this->rows; i++) {
-        result += matrix[i][i];
+        result += data[i * stride + i];
+    }
+
+    return result;
+}
+
+Comparison Matrix::compare(const Matrix &a, Tolerance mode, double tolerance, bool stop_at_mismatch) const {
+    a.check_size(this->rows, this->columns);
+
+    auto mismatch = mode == Tolerance::Absolute ? detail::mismatch_absolute
+                  : mode == Tolerance::Relative ? detail::mismatch_relative
+                  : detail::mismatch_ulp;
+
+    // Matrices without row padding are compared as one run, others row by row.
+    bool flat = (this->stride == this->columns && a.stride == a.columns) || this->rows <= 1;
+    size_t runs = flat ? 1 : this->rows;
+    size_t length = flat ? this->rows * this->columns : this->columns;
+
+    Comparison result;
+    for (size_t run = 0; run < runs; run++) {
+        size_t index = mismatch(this->data + run * this->stride, a.data + run * a.stride, length, tolerance,
+                                &result.max_deviation, stop_at_mismatch);
+        if (index < length && result.equal) {
+            result.equal = false;
+            result.row = (run * length + index) / this->columns;
+            result.column = (run * length + index) % this->columns;
+            if (stop_at_mismatch) {
+                break;
+            }
+        }
     }
 
     return result;
 }
 
 bool Matrix::operator==(const Matrix &a) const {
-    if (this->rows != a.rows || this->columns != a.columns) {
-        return false;
+    return this->rows == a.rows && this->columns == a.columns && this->compare(a).equal;
+}
+
+bool Matrix::operator!=(const Matrix &a) const {
+    return !(*this == a);
+}
+
+namespace {
+
+    const int ROUNDTRIP_INDEX = std::ios_base::xalloc();
+
+#ifdef MATRIX_STREAM_FAST_PATH
+
+    const int END_OF_FILE = std::char_traits<char>::eof();
+
+    bool is_space(int c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
     }
 
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            if (this->matrix[i][j] - a.matrix[i][j] > EPS || a.matrix[i][j] - this->matrix[i][j] > EPS) {
-                return false;
+    // Replaces token with the next whitespace-delimited token, which is empty at end of input.
+    // Whatever follows the token stays in the stream.
+    void read_token(std::istream &input, std::string &token) {
+        std::streambuf *buffer = input.rdbuf();
+
+        int c = buffer->sgetc();
+        while (c != END_OF_FILE && is_space(c)) {
+            c = buffer->snextc();
+        }
+
+        token.clear();
+        while (c != END_OF_FILE && !is_space(c)) {
+            token.push_back(static_cast<char>(c));
+            c = buffer->snextc();
+        }
+
+        if (c == END_OF_FILE) {
+            input.setstate(std::ios_base::eofbit);
+        }
+    }
+
+    // std::cin synchronized with stdio (the default) has no get area, and reading it through
+    // the streambuf costs a virtual call per character. libstdc++'s buffer exposes its FILE,
+    // which is then read directly; returns nullptr for every other buffer.
+    FILE *stdio_file(std::streambuf *buffer) {
+        if (auto *sync = dynamic_cast<__gnu_cxx::stdio_sync_filebuf<char> *>(buffer)) {
+            return sync->file();
+        }
+        return nullptr;
+    }
+
+    // Holds the lock of a FILE (if any) so that it can be read with getc_unlocked.
+    struct FileLock {
+        FILE *file;
+
+        explicit FileLock(FILE *file) : file(file) {
+            if (file) {
+                flockfile(file);
+            }
+        }
+
+        FileLock(const FileLock &) = delete;
+
+        FileLock &operator=(const FileLock &) = delete;
+
+        ~FileLock() {
+            if (file) {
+                funlockfile(file);
             }
         }
+    };
+
+    // Same as above for a locked FILE; the delimiter is pushed back.
+    void read_token(std::istream &input, FILE *file, std::string &token) {
+        int c = getc_unlocked(file);
+        while (c != EOF && is_space(c)) {
+            c = getc_unlocked(file);
+        }
+
+        token.clear();
+        while (c != EOF && !is_space(c)) {
+            token.push_back(static_cast<char>(c));
+            c = getc_unlocked(file);
+        }
+
+        if (c == EOF) {
+            input.setstate(std::ios_base::eofbit);
+        } else {
+            ungetc(c, file);
+        }
     }
 
-    return true;
-}
+    // Reaches the protected get area of an arbitrary streambuf through member pointers
+    // named via a derived class, which the access rules allow.
+    class GetArea : public std::streambuf {
+    public:
 
-bool Matrix::operator!=(const Matrix &a) const {
-    if (this->rows != a.rows || this->columns != a.columns) {
+        static const char *begin(std::streambuf *buffer) {
+            return (buffer->*&GetArea::gptr)();
+        }
+
+        static const char *end(std::streambuf *buffer) {
+            return (buffer->*&GetArea::egptr)();
+        }
+
+        static void advance(std::streambuf *buffer, size_t count) {
+            (buffer->*&GetArea::gbump)(static_cast<int>(count));
+        }
+    };
+
+    template<class T>
+    bool parse_token(std::istream &input, const char *first, const char *last, T &value) {
+        if (last - first > 1 && *first == '+') {
+            first++;
+        }
+
+        std::from_chars_result result = std::from_chars(first, last, value);
+        if (first == last || result.ec != std::errc() || result.ptr != last) {
+            input.setstate(std::ios_base::failbit);
+            return false;
+        }
         return true;
     }
 
-    for (size_t i = 0; i < this->rows; i++) {
-        for (size_t j = 0; j < this->columns; j++) {
-            if (matrix[i][j] - a.matrix[i][j] > EPS || a.matrix[i][j] - matrix[i][j] > EPS) {
-                return true;
-            }
+    // Parses tokens in place while they lie wholly inside the buffered input and falls
+    // back to copying them character by character into token, which is reused between calls,
+    // when a token may straddle a refill or the stream is a stdio FILE.
+    template<class T>
+    bool read_value(std::istream &input, FILE *file, std::string &token, T &value) {
+        if (file) {
+            read_token(input, file, token);
+            return parse_token(input, token.data(), token.data() + token.size(), value);
         }
+
+        std::streambuf *buffer = input.rdbuf();
+        const char *begin = GetArea::begin(buffer);
+        const char *end = GetArea::end(buffer);
+
+        const char *first = begin;
+        while (first < end && is_space(*first)) {
+            first++;
+        }
+        const char *last = first;
+        while (last < end && !is_space(*last)) {
+            last++;
+        }
+
+        if (last < end) {
+            GetArea::advance(buffer, last - begin);
+            return parse_token(input, first, last, value);
+        }
+
+        GetArea::advance(buffer, first - begin);
+        read_token(input, token);
+        return parse_token(input, token.data(), token.data() + token.size(), value);
     }
 
-    return false;
-}
+    // Longest output of format_value: a sign, 309 integer digits, the point and `precision`
+    // decimals in fixed notation, which also bounds the scientific, general and shortest forms.
+    size_t max_formatted_length(const std::ostream &output) {
+        return 320 + static_cast<size_t>(std::max<std::streamsize>(output.precision(), 0));
+    }
+
+    // Returns nullptr if the value does not fit [first, last).
+    char *format_value(std::ostream &output, double value, char *first, char *last) {
+        std::ios_base::fmtflags float_field = output.flags() & std::ios_base::floatfield;
+        int precision = static_cast<int>(output.precision());
+
+        std::to_chars_result result;
+        if (output.iword(ROUNDTRIP_INDEX) != 0) {
+            result = std::to_chars(first, last, value);
+        } else if (float_field == std::ios_base::fixed) {
+            result = std::to_chars(first, last, value, std::chars_format::fixed, precision);
+        } else if (float_field == std::ios_base::scientific) {
+            result = std::to_chars(first, last, value, std::chars_format::scientific, precision);
+        } else {
+            result = std::to_chars(first, last, value, std::chars_format::general, precision);
+        }
+        return result.ec == std::errc() ? result.ptr : nullptr;
+    }
+
+#endif
+
+}  // namespace
 
 std::ostream &task::operator<<(std::ostream &output, const Matrix &matrix) {
+#ifndef MATRIX_STREAM_FAST_PATH
+    // Without to_chars the round-trip form is max_digits10 significant digits, not the shortest.
+    std::ios_base::fmtflags flags = output.flags();
+    std::streamsize precision = output.precision();
+    if (output.iword(ROUNDTRIP_INDEX) != 0) {
+        output.unsetf(std::ios_base::floatfield);
+        output.precision(std::numeric_limits<double>::max_digits10);
+    }
+
     for (size_t i = 0; i < matrix.getRowsNum(); i++) {
         for (size_t j = 0; j < matrix.getColumnsNum(); j++) {
             output << matrix[i][j] << ' ';
@@ -352,33 +855,150 @@ std::ostream &task::operator<<(std::ostream &output, const Matrix &matrix) {
         output << '\n';
     }
 
+    output.flags(flags);
+    output.precision(precision);
+    return output;
+#else
+    const size_t capacity = 1 << 14;
+    // Room for one more value and the separator after it once capacity is reached.
+    const size_t reserve = max_formatted_length(output) + 2;
+
+    char *buffer = new char[capacity + reserve];
+    char *position = buffer;
+
+    for (size_t i = 0; i < matrix.getRowsNum(); i++) {
+        const double *row = matrix.getColumnsNum() == 0 ? nullptr : matrix[i];
+        for (size_t j = 0; j < matrix.getColumnsNum(); j++) {
+            position = format_value(output, row[j], position, buffer + capacity + reserve - 2);
+            if (!position) {
+                output.setstate(std::ios_base::failbit);
+                delete[] buffer;
+                return output;
+            }
+            *position++ = ' ';
+
+            if (static_cast<size_t>(position - buffer) >= capacity) {
+                output.write(buffer, position - buffer);
+                position = buffer;
+            }
+        }
+        *position++ = '\n';
+    }
+    output.write(buffer, position - buffer);
+
+    delete[] buffer;
     return output;
+#endif
 }
 
 std::istream &task::operator>>(std::istream &input, Matrix &matrix) {
+    std::istream::sentry sentry(input);
+    if (!sentry) {
+        return input;
+    }
+
+#ifndef MATRIX_STREAM_FAST_PATH
     size_t n, m;
-    input >> n >> m;
+    if (!(input >> n >> m)) {
+        return input;
+    }
 
-    matrix.resize(n, m);
+    if (matrix.getRowsNum() != n || matrix.getColumnsNum() != m) {
+        matrix = Matrix(n, m);
+    }
+    if (m == 0) {
+        return input;
+    }
 
     for (size_t i = 0; i < n; i++) {
+        double *row = matrix[i];
         for (size_t j = 0; j < m; j++) {
-            input >> matrix[i][j];
+            if (!(input >> row[j])) {
+                return input;
+            }
         }
     }
 
     return input;
-}
+#else
+    FileLock lock(stdio_file(input.rdbuf()));
+    std::string token;
+
+    size_t n, m;
+    if (!read_value(input, lock.file, token, n) || !read_value(input, lock.file, token, m)) {
+        return input;
+    }
 
-Matrix task::operator*(const double &a, const Matrix &b) {
-    Matrix new_matrix(b);
+    if (matrix.getRowsNum() != n || matrix.getColumnsNum() != m) {
+        matrix = Matrix(n, m);
+    }
+    if (m == 0) {
+        return input;
+    }
 
-    for (size_t i = 0; i < b.getRowsNum(); i++) {
-        for (size_t j = 0; j < b.getColumnsNum(); j++) {
-            new_matrix[i][j] *= a;
+    for (size_t i = 0; i < n; i++) {
+        double *row = matrix[i];
+        for (size_t j = 0; j < m; j++) {
+            if (!read_value(input, lock.file, token, row[j])) {
+                return input;
+            }
         }
     }
-    return new_matrix;
+
+    return input;
+#endif
+}
+
+std::ostream &task::roundtrip(std::ostream &output) {
+    output.iword(ROUNDTRIP_INDEX) = 1;
+    return output;
+}
+
+std::ostream &task::noroundtrip(std::ostream &output) {
+    output.iword(ROUNDTRIP_INDEX) = 0;
+    return output;
+}
+
+MatrixView Matrix::view() {
+    detach();
+    return MatrixView(this->data, this->rows, this->columns, this->stride, 1);
+}
+
+ConstMatrixView Matrix::view() const {
+    return ConstMatrixView(this->data, this->rows, this->columns, this->stride, 1);
+}
+
+MatrixView Matrix::row(size_t row) {
+    return view().row(row);
+}
+
+ConstMatrixView Matrix::row(size_t row) const {
+    return view().row(row);
+}
+
+MatrixView Matrix::column(size_t col) {
+    return view().column(col);
+}
+
+ConstMatrixView Matrix::column(size_t col) const {
+    return view().column(col);
+}
+
+MatrixView Matrix::block(size_t row, size_t col, size_t rows, size_t cols) {
+    return view().block(row, col, rows, cols);
+}
+
+ConstMatrixView Matrix::block(size_t row, size_t col, size_t rows, size_t cols) const {
+    return view().block(row, col, rows, cols);
+}
+
+MatrixView Matrix::diagonal() {
+    detach();
+    return MatrixView(this->data, std::min(this->rows, this->columns), 1, this->stride + 1, 0);
+}
+
+ConstMatrixView Matrix::diagonal() const {
+    return ConstMatrixView(this->data, std::min(this->rows, this->columns), 1, this->stride + 1, 0);
 }
 
 std::vector<double> Matrix::getRow(size_t row) {
@@ -386,13 +1006,8 @@ std::vector<double> Matrix::getRow(size_t row) {
         throw SizeMismatchException();
     }
 
-    std::vector<double> row_vec;
-    row_vec.reserve(this->columns);
-    for (size_t i = 0; i < this->columns; i++) {
-        row_vec.push_back(matrix[row][i]);
-    }
-
-    return row_vec;
+    const double *begin = this->data + row * this->stride;
+    return std::vector<double>(begin, begin + this->columns);
 }
 
 std::vector<double> Matrix::getColumn(size_t column) {
@@ -403,7 +1018,7 @@ std::vector<double> Matrix::getColumn(size_t column) {
     column_vec.reserve(this->rows);
 
     for (size_t i = 0; i < this->rows; i++) {
-        column_vec.push_back(matrix[i][column]);
+        column_vec.push_back(data[i * stride + column]);
     }
 
     return column_vec;
@@ -415,4 +1030,8 @@ size_t Matrix::getRowsNum() const {
 
 size_t Matrix::getColumnsNum() const {
     return this->columns;
-}
\ No newline at end of file
+}
+
+std::pmr::memory_resource *Matrix::getResource() const {
+    return this->resource;
+}
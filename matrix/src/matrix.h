@@ -1,7 +1,12 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 #include <iostream>
+#include <memory_resource>
+#include "kernels.h"
+#include "matrix_view.h"
+#include "matrix_expression.h"
 
 
 namespace task {
@@ -16,35 +21,186 @@ namespace task {
     };
 
 
+    // How Matrix::sum, rowSums and columnSums accumulate. Naive adds each stretch with one set
+    // of SIMD lane accumulators; Pairwise splits it in halves down to short blocks, so the
+    // error grows with log n rather than n; Kahan carries a compensation term in every lane.
+    // All three are single passes over the data.
+    enum class Summation {
+        Naive, Pairwise, Kahan
+    };
+
+
+    // How Matrix::compare measures the deviation of two elements: |a - b|,
+    // |a - b| / max(|a|, |b|), or the number of representable doubles between them.
+    enum class Tolerance {
+        Absolute, Relative, Ulp
+    };
+
+    // Outcome of Matrix::compare. row and column locate the first element, in row-major order,
+    // whose deviation exceeds the tolerance and are only set when !equal. max_deviation covers
+    // the elements up to that one, or all of them when the comparison does not stop there.
+    struct Comparison {
+        bool equal = true;
+        size_t row = 0;
+        size_t column = 0;
+        double max_deviation = 0.0;
+    };
+
+
+    // Memory resource that new Matrix buffers on this thread come from; nullptr, the default,
+    // means global new[] / delete[].
+    std::pmr::memory_resource *getMatrixResource();
+
+    // Returns the previous resource.
+    std::pmr::memory_resource *setMatrixResource(std::pmr::memory_resource *resource);
+
+    // Sends every Matrix allocated on this thread while in scope, temporaries made inside the
+    // operators included, to `resource` (e.g. a std::pmr::monotonic_buffer_resource arena) and
+    // restores the previous resource on exit. Such matrices must not outlive the resource.
+    class MatrixResourceScope {
+        std::pmr::memory_resource *previous;
+
+    public:
+
+        explicit MatrixResourceScope(std::pmr::memory_resource *resource);
+
+        MatrixResourceScope(const MatrixResourceScope &) = delete;
+
+        MatrixResourceScope &operator=(const MatrixResourceScope &) = delete;
+
+        ~MatrixResourceScope();
+    };
+
+
+    // Copies share one reference-counted buffer and the first mutating access (set, the
+    // non-const get / operator[] / views, compound operators, transpose) makes a private copy.
+    // Pointers and views taken before a copy was made still point into the shared buffer.
+    // Matrices of up to INLINE_CAPACITY elements live in the object itself and never allocate;
+    // like std::string's small buffer, their pointers and views do not survive a move.
     class Matrix {
-        double **matrix;
+        static const size_t INLINE_CAPACITY = 16;
+
+        double *data;
         size_t rows;
         size_t columns;
+        size_t stride;
+        // Elements in data, at least rows * stride; stays fixed while transpose() and
+        // same-size assignment reshape it.
+        size_t allocated;
+        // Chosen at construction and kept for every later reallocation.
+        std::pmr::memory_resource *resource;
+        alignas(std::max_align_t) double local[INLINE_CAPACITY];
 
         void allocate_memory();
 
+        // Leaves data uninitialized with room for row_capacity rows of `stride` elements.
+        void allocate_memory(size_t row_capacity, size_t stride);
+
+        // Moves the current elements into a new buffer of the given shape.
+        void reallocate(size_t row_capacity, size_t stride);
+
+        size_t row_capacity() const;
+
+        void release_memory(double *buffer, size_t count) const;
+
+        // Moves other's storage into this uninitialized object and leaves other empty.
+        void take(Matrix &other) noexcept;
+
+        void share(const Matrix &other);
+
+        bool shared() const;
+
+        // Gives this matrix its own buffer before a write if other copies still use it.
+        void detach();
+
+        void copy_from(const double *source, size_t source_stride);
+
         void check_bounds(size_t, size_t) const;
 
         void check_size(size_t, size_t) const;
 
+        void combine(const Matrix &a, const Matrix &b, void (*kernel)(const double *, const double *, double *, size_t));
+
+        void scale_from(const Matrix &a, double factor);
+
+        template<class E>
+        void assign(const E &expression);
+
+        template<class L, class R>
+        void assign(const expr::BinaryExpression<L, R, std::plus<double>> &expression);
+
+        template<class L, class R>
+        void assign(const expr::BinaryExpression<L, R, std::minus<double>> &expression);
+
+        template<class E>
+        void assign(const expr::UnaryExpression<E, expr::Scale> &expression);
+
+        template<class E>
+        void assign(const expr::UnaryExpression<E, std::negate<double>> &expression);
+
+        template<class E>
+        void assign_elementwise(const E &expression);
+
+        friend double expr::element(const Matrix &, size_t, size_t);
+
+        friend Matrix expr::multiply(const ConstMatrixView &left, const ConstMatrixView &right);
+
+        friend std::vector<double> operator*(const std::vector<double> &vector, const Matrix &matrix);
+
+        friend void gemv(double alpha, const Matrix &a, const std::vector<double> &x,
+                         double beta, std::vector<double> &y, bool transposed);
+
+        friend void gemm(double alpha, const Matrix &a, const Matrix &b, double beta, Matrix &c,
+                         bool transpose_a, bool transpose_b);
+
     public:
 
         Matrix();
 
         Matrix(size_t rows, size_t cols);
 
+        Matrix(size_t rows, size_t cols, std::pmr::memory_resource *resource);
+
         Matrix(const Matrix &copy);
 
+        Matrix(Matrix &&other) noexcept;
+
         Matrix &operator=(const Matrix &a);
 
+        // Steals other's buffer only when both use the same resource; otherwise the elements are
+        // copied into this matrix's resource, so the assignment may allocate.
+        Matrix &operator=(Matrix &&other);
+
+        // Expressions built by +, - and scalar * are evaluated here in a single fused pass.
+        // Assigning writes in place, so this matrix may appear in the expression, but a view of
+        // its storage may only read the element being written (no transposed or shifted views).
+        template<class E, class = std::enable_if_t<expr::is_lazy<E>::value>>
+        Matrix(const E &expression);
+
+        template<class E, class = std::enable_if_t<expr::is_lazy<E>::value>>
+        Matrix &operator=(const E &expression);
+
         double &get(size_t row, size_t col);
 
         const double &get(size_t row, size_t col) const;
 
         void set(size_t row, size_t col, const double &value);
 
+        // Keeps the overlapping elements and zero-fills the rest. Works in place while the
+        // reserved shape suffices; otherwise the outgrown dimension's capacity is doubled.
         void resize(size_t new_rows, size_t new_cols);
 
+        // Makes room for rows x cols without reallocating in later resize calls.
+        void reserve(size_t rows, size_t cols);
+
+        // Number of elements the current buffer holds.
+        size_t capacity() const;
+
+        // Amortized O(columns) / O(rows) thanks to resize's geometric growth.
+        void appendRow(const std::vector<double> &row);
+
+        void appendColumn(const std::vector<double> &column);
+
         double *operator[](size_t row);
 
         double const *operator[](size_t row) const;
@@ -53,21 +209,24 @@ namespace task {
 
         Matrix &operator-=(const Matrix &a);
 
-        Matrix &operator*=(const Matrix &a);
+        template<class E, class = std::enable_if_t<expr::is_lazy<E>::value>>
+        Matrix &operator+=(const E &expression);
 
-        Matrix &operator*=(const double &number);
+        template<class E, class = std::enable_if_t<expr::is_lazy<E>::value>>
+        Matrix &operator-=(const E &expression);
 
-        Matrix operator+(const Matrix &a) const;
+        Matrix &operator*=(const Matrix &a);
 
-        Matrix operator-(const Matrix &a) const;
+        Matrix &operator*=(const double &number);
 
         Matrix operator*(const Matrix &a) const;
 
-        Matrix operator*(const double &a) const;
+        // Matrix-vector product without wrapping the vector in an n x 1 Matrix.
+        std::vector<double> operator*(const std::vector<double> &vector) const;
 
-        Matrix operator-() const;
+        Matrix operator+() const &;
 
-        Matrix operator+() const;
+        Matrix operator+() &&;
 
         double det() const;
 
@@ -77,10 +236,64 @@ namespace task {
 
         double trace() const;
 
+        // Large matrices are reduced in fixed chunks on the thread pool, and the partial results
+        // are combined with compensated summation; the chunks do not depend on the number of
+        // threads, so neither does the result.
+        double sum(Summation mode = Summation::Pairwise) const;
+
+        std::vector<double> rowSums(Summation mode = Summation::Pairwise) const;
+
+        std::vector<double> columnSums(Summation mode = Summation::Pairwise) const;
+
+        // NaN elements are skipped; an empty matrix gives +inf / -inf.
+        double min() const;
+
+        double max() const;
+
+        // maxAbs() and the norms are NaN if any element is NaN and 0 for an empty matrix.
+        double maxAbs() const;
+
+        // Frobenius norm, rescaled like LAPACK's dnrm2 when the squares over- or underflow.
+        double norm() const;
+
+        // Largest absolute column sum.
+        double norm1() const;
+
+        // Largest absolute row sum.
+        double normInf() const;
+
+        MatrixView view();
+
+        ConstMatrixView view() const;
+
+        MatrixView row(size_t row);
+
+        ConstMatrixView row(size_t row) const;
+
+        MatrixView column(size_t col);
+
+        ConstMatrixView column(size_t col) const;
+
+        MatrixView block(size_t row, size_t col, size_t rows, size_t cols);
+
+        ConstMatrixView block(size_t row, size_t col, size_t rows, size_t cols) const;
+
+        // min(rows, columns) x 1 view of the main diagonal.
+        MatrixView diagonal();
+
+        ConstMatrixView diagonal() const;
+
         std::vector<double> getRow(size_t row);
 
         std::vector<double> getColumn(size_t column);
 
+        // Single vectorized pass that exits at the first mismatch when stop_at_mismatch is set.
+        // Equal values are 0 apart and NaNs never match. Throws SizeMismatchException for
+        // matrices of different shapes.
+        Comparison compare(const Matrix &a, Tolerance mode = Tolerance::Absolute, double tolerance = EPS,
+                           bool stop_at_mismatch = true) const;
+
+        // Absolute comparison within EPS.
         bool operator==(const Matrix &a) const;
 
         bool operator!=(const Matrix &a) const;
@@ -89,14 +302,42 @@ namespace task {
 
         size_t getColumnsNum() const;
 
+        std::pmr::memory_resource *getResource() const;
+
         ~Matrix();
     };
 
-    Matrix operator*(const double &a, const Matrix &b);
+    // Row vector times matrix: result[j] = sum_i vector[i] * matrix[i][j].
+    std::vector<double> operator*(const std::vector<double> &vector, const Matrix &matrix);
+
+    // y = alpha * A * x + beta * y, or alpha * A^T * x + beta * y when transposed. y must
+    // already have the output size; with beta == 0 its old contents are ignored. x may be y,
+    // in which case it is copied first, as gemm() does for an aliased c.
+    void gemv(double alpha, const Matrix &a, const std::vector<double> &x,
+              double beta, std::vector<double> &y, bool transposed = false);
 
+    // c = alpha * op(a) * op(b) + beta * c in place, where op transposes its operand when the
+    // matching flag is set. Transposed operands are read through their strides, and c is
+    // updated without allocating unless it is also one of the inputs.
+    void gemm(double alpha, const Matrix &a, const Matrix &b, double beta, Matrix &c,
+              bool transpose_a = false, bool transpose_b = false);
+
+    // Elements are formatted with std::to_chars using the stream's precision and
+    // fixed / scientific flags, or as the shortest round-trip form after `output << roundtrip`.
+    // Builds without the fast stream path (see matrix.cpp) use operator<< on each element.
     std::ostream &operator<<(std::ostream &output, const Matrix &matrix);
 
+    // Reads "rows cols" and then the values straight from the stream buffer with std::from_chars,
+    // or with operator>> on each value in builds without the fast stream path.
     std::istream &operator>>(std::istream &input, Matrix &matrix);
 
+    std::ostream &roundtrip(std::ostream &output);
+
+    std::ostream &noroundtrip(std::ostream &output);
+
 
 }  // namespace task
+
+
+#include "matrix_view.tpp"
+#include "matrix_expression.tpp"
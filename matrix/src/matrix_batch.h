@@ -0,0 +1,109 @@
+#pragma once
+
+#include <new>
+#include <cstddef>
+#include <vector>
+#include "fixed_matrix.h"
+
+
+namespace task {
+
+    namespace detail {
+
+        // std::vector allocator whose storage starts on a 64-byte cache line.
+        template<class T>
+        struct CacheLineAllocator {
+            using value_type = T;
+
+            static constexpr size_t ALIGNMENT = 64;
+
+            CacheLineAllocator() = default;
+
+            template<class U>
+            CacheLineAllocator(const CacheLineAllocator<U> &) {
+            }
+
+            T *allocate(size_t n) {
+                return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(ALIGNMENT)));
+            }
+
+            void deallocate(T *p, size_t) {
+                ::operator delete(p, std::align_val_t(ALIGNMENT));
+            }
+
+            template<class U>
+            bool operator==(const CacheLineAllocator<U> &) const {
+                return true;
+            }
+
+            template<class U>
+            bool operator!=(const CacheLineAllocator<U> &) const {
+                return false;
+            }
+        };
+
+    }  // namespace detail
+
+    // N independent R x C matrices stored structure-of-arrays: element (i, j) of every matrix
+    // lives in one contiguous lane, so each kernel is a handful of unit-stride loops over the
+    // batch that the compiler vectorizes. New matrices are identities, as with FixedMatrix.
+    template<size_t R, size_t C>
+    class MatrixBatch {
+        static_assert(R > 0 && C > 0, "MatrixBatch dimensions must be positive");
+
+        // Storage is cache-line aligned and lanes are padded to a multiple of LANE_ALIGN
+        // elements, so every lane starts on a cache line.
+        static constexpr size_t LANE_ALIGN = 8;
+
+        // Matrices per pass of the product kernel.
+        static constexpr size_t BLOCK = 256;
+
+        std::vector<double, detail::CacheLineAllocator<double>> values;
+        size_t count;
+        size_t stride;
+
+        void check_size(size_t count) const;
+
+    public:
+
+        explicit MatrixBatch(size_t count = 0);
+
+        size_t size() const;
+
+        static constexpr size_t getRowsNum();
+
+        static constexpr size_t getColumnsNum();
+
+        // Lane of element (row, col): lane(row, col)[k] is that element of matrix k.
+        double *lane(size_t row, size_t col);
+
+        const double *lane(size_t row, size_t col) const;
+
+        double &operator()(size_t index, size_t row, size_t col);
+
+        const double &operator()(size_t index, size_t row, size_t col) const;
+
+        FixedMatrix<R, C> get(size_t index) const;
+
+        void set(size_t index, const FixedMatrix<R, C> &matrix);
+
+        template<size_t K>
+        MatrixBatch<R, K> operator*(const MatrixBatch<C, K> &a) const;
+
+        MatrixBatch<C, R> transposed() const;
+
+        std::vector<double> det() const;
+
+        std::vector<double> trace() const;
+    };
+
+    using Matrix2Batch = MatrixBatch<2, 2>;
+
+    using Matrix3Batch = MatrixBatch<3, 3>;
+
+    using Matrix4Batch = MatrixBatch<4, 4>;
+
+}  // namespace task
+
+
+#include "matrix_batch.tpp"
@@ -0,0 +1,211 @@
+#include "matrix_batch.h"
+#include <algorithm>
+
+namespace task {
+
+    template<size_t R, size_t C>
+    MatrixBatch<R, C>::MatrixBatch(size_t count)
+            : values(), count(count), stride((count + LANE_ALIGN - 1) / LANE_ALIGN * LANE_ALIGN) {
+        this->values.assign(R * C * this->stride, 0.0);
+        for (size_t i = 0; i < (R < C ? R : C); i++) {
+            double *diagonal = this->lane(i, i);
+            for (size_t k = 0; k < count; k++) {
+                diagonal[k] = 1.0;
+            }
+        }
+    }
+
+    template<size_t R, size_t C>
+    void MatrixBatch<R, C>::check_size(size_t count) const {
+        if (this->count != count) {
+            throw SizeMismatchException();
+        }
+    }
+
+    template<size_t R, size_t C>
+    size_t MatrixBatch<R, C>::size() const {
+        return this->count;
+    }
+
+    template<size_t R, size_t C>
+    constexpr size_t MatrixBatch<R, C>::getRowsNum() {
+        return R;
+    }
+
+    template<size_t R, size_t C>
+    constexpr size_t MatrixBatch<R, C>::getColumnsNum() {
+        return C;
+    }
+
+    template<size_t R, size_t C>
+    double *MatrixBatch<R, C>::lane(size_t row, size_t col) {
+        return this->values.data() + (row * C + col) * this->stride;
+    }
+
+    template<size_t R, size_t C>
+    const double *MatrixBatch<R, C>::lane(size_t row, size_t col) const {
+        return this->values.data() + (row * C + col) * this->stride;
+    }
+
+    template<size_t R, size_t C>
+    double &MatrixBatch<R, C>::operator()(size_t index, size_t row, size_t col) {
+        if (index >= this->count || row >= R || col >= C) {
+            throw OutOfBoundsException();
+        }
+        return this->lane(row, col)[index];
+    }
+
+    template<size_t R, size_t C>
+    const double &MatrixBatch<R, C>::operator()(size_t index, size_t row, size_t col) const {
+        if (index >= this->count || row >= R || col >= C) {
+            throw OutOfBoundsException();
+        }
+        return this->lane(row, col)[index];
+    }
+
+    template<size_t R, size_t C>
+    FixedMatrix<R, C> MatrixBatch<R, C>::get(size_t index) const {
+        if (index >= this->count) {
+            throw OutOfBoundsException();
+        }
+        FixedMatrix<R, C> new_matrix;
+        for (size_t i = 0; i < R; i++) {
+            for (size_t j = 0; j < C; j++) {
+                new_matrix(i, j) = this->lane(i, j)[index];
+            }
+        }
+        return new_matrix;
+    }
+
+    template<size_t R, size_t C>
+    void MatrixBatch<R, C>::set(size_t index, const FixedMatrix<R, C> &matrix) {
+        if (index >= this->count) {
+            throw OutOfBoundsException();
+        }
+        for (size_t i = 0; i < R; i++) {
+            for (size_t j = 0; j < C; j++) {
+                this->lane(i, j)[index] = matrix(i, j);
+            }
+        }
+    }
+
+    template<size_t R, size_t C>
+    template<size_t K>
+    MatrixBatch<R, K> MatrixBatch<R, C>::operator*(const MatrixBatch<C, K> &a) const {
+        this->check_size(a.size());
+
+        MatrixBatch<R, K> new_matrix(this->count);
+
+        // Walk the batch in blocks that keep the operand lanes in L1, accumulating each output
+        // element in registers; the p loop has a constant trip count and is unrolled.
+        for (size_t start = 0; start < this->count; start += BLOCK) {
+            size_t end = start + BLOCK < this->count ? start + BLOCK : this->count;
+            for (size_t i = 0; i < R; i++) {
+                for (size_t j = 0; j < K; j++) {
+                    const double *left[C];
+                    const double *right[C];
+                    for (size_t p = 0; p < C; p++) {
+                        left[p] = this->lane(i, p);
+                        right[p] = a.lane(p, j);
+                    }
+                    double *out = new_matrix.lane(i, j);
+                    for (size_t k = start; k < end; k++) {
+                        double sum = 0.0;
+                        for (size_t p = 0; p < C; p++) {
+                            sum += left[p][k] * right[p][k];
+                        }
+                        out[k] = sum;
+                    }
+                }
+            }
+        }
+        return new_matrix;
+    }
+
+    template<size_t R, size_t C>
+    MatrixBatch<C, R> MatrixBatch<R, C>::transposed() const {
+        // In SoA layout a transpose only permutes whole lanes.
+        MatrixBatch<C, R> new_matrix(this->count);
+        for (size_t i = 0; i < R; i++) {
+            for (size_t j = 0; j < C; j++) {
+                std::copy(this->lane(i, j), this->lane(i, j) + this->count, new_matrix.lane(j, i));
+            }
+        }
+        return new_matrix;
+    }
+
+    template<size_t R, size_t C>
+    std::vector<double> MatrixBatch<R, C>::det() const {
+        static_assert(R == C, "det() requires a square matrix");
+
+        std::vector<double> result(this->count);
+        double *out = result.data();
+        size_t n = this->count;
+
+        // Filled with constant indices so the table is scalarized and the lane loops vectorize.
+        const double *m[R][C];
+        detail::unroll<R * C>([&](auto index) {
+            m[index / C][index % C] = this->lane(index / C, index % C);
+        });
+
+        // Same closed forms as FixedMatrix::det, evaluated lane-wise. Results go to a stack block
+        // first: with one lane per element, the runtime alias checks against out would exceed
+        // what the vectorizer is willing to version for.
+        if constexpr (R == 1) {
+            std::copy(m[0][0], m[0][0] + n, out);
+        } else if constexpr (R <= 4) {
+            for (size_t start = 0; start < n; start += BLOCK) {
+                size_t end = start + BLOCK < n ? start + BLOCK : n;
+                double block[BLOCK];
+                for (size_t k = start; k < end; k++) {
+                    if constexpr (R == 2) {
+                        block[k - start] = m[0][0][k] * m[1][1][k] - m[0][1][k] * m[1][0][k];
+                    } else if constexpr (R == 3) {
+                        block[k - start] = m[0][0][k] * (m[1][1][k] * m[2][2][k] - m[1][2][k] * m[2][1][k])
+                                           - m[0][1][k] * (m[1][0][k] * m[2][2][k] - m[1][2][k] * m[2][0][k])
+                                           + m[0][2][k] * (m[1][0][k] * m[2][1][k] - m[1][1][k] * m[2][0][k]);
+                    } else {
+                        double s0 = m[0][0][k] * m[1][1][k] - m[1][0][k] * m[0][1][k];
+                        double s1 = m[0][0][k] * m[1][2][k] - m[1][0][k] * m[0][2][k];
+                        double s2 = m[0][0][k] * m[1][3][k] - m[1][0][k] * m[0][3][k];
+                        double s3 = m[0][1][k] * m[1][2][k] - m[1][1][k] * m[0][2][k];
+                        double s4 = m[0][1][k] * m[1][3][k] - m[1][1][k] * m[0][3][k];
+                        double s5 = m[0][2][k] * m[1][3][k] - m[1][2][k] * m[0][3][k];
+
+                        double c5 = m[2][2][k] * m[3][3][k] - m[3][2][k] * m[2][3][k];
+                        double c4 = m[2][1][k] * m[3][3][k] - m[3][1][k] * m[2][3][k];
+                        double c3 = m[2][1][k] * m[3][2][k] - m[3][1][k] * m[2][2][k];
+                        double c2 = m[2][0][k] * m[3][3][k] - m[3][0][k] * m[2][3][k];
+                        double c1 = m[2][0][k] * m[3][2][k] - m[3][0][k] * m[2][2][k];
+                        double c0 = m[2][0][k] * m[3][1][k] - m[3][0][k] * m[2][1][k];
+
+                        block[k - start] = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+                    }
+                }
+                std::copy(block, block + (end - start), out + start);
+            }
+        } else {
+            // Pivoting branches per matrix, so larger sizes are not vectorized across the batch.
+            for (size_t k = 0; k < n; k++) {
+                out[k] = this->get(k).det();
+            }
+        }
+        return result;
+    }
+
+    template<size_t R, size_t C>
+    std::vector<double> MatrixBatch<R, C>::trace() const {
+        static_assert(R == C, "trace() requires a square matrix");
+
+        std::vector<double> result(this->count, 0.0);
+        double *out = result.data();
+        for (size_t i = 0; i < R; i++) {
+            const double *diagonal = this->lane(i, i);
+            for (size_t k = 0; k < this->count; k++) {
+                out[k] += diagonal[k];
+            }
+        }
+        return result;
+    }
+
+}  // namespace task
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+
+namespace task {
+
+    class Matrix;
+
+    template<class T>
+    class BasicMatrixView;
+
+    namespace expr {
+
+        template<class L, class R, class Op>
+        class BinaryExpression;
+
+        template<class E, class Op>
+        class UnaryExpression;
+
+        template<class T>
+        struct is_node : std::false_type {
+        };
+
+        template<class L, class R, class Op>
+        struct is_node<BinaryExpression<L, R, Op>> : std::true_type {
+        };
+
+        template<class E, class Op>
+        struct is_node<UnaryExpression<E, Op>> : std::true_type {
+        };
+
+        template<class T>
+        struct is_view : std::false_type {
+        };
+
+        template<class T>
+        struct is_view<BasicMatrixView<T>> : std::true_type {
+        };
+
+        // Anything that is an expression but not an owning Matrix.
+        template<class T>
+        struct is_lazy : std::integral_constant<bool, is_node<T>::value || is_view<T>::value> {
+        };
+
+        template<class T>
+        struct is_leaf : std::is_same<std::decay_t<T>, Matrix> {
+        };
+
+        template<class T>
+        struct is_expression : std::integral_constant<bool,
+                is_lazy<T>::value || std::is_same<T, Matrix>::value> {
+        };
+
+        // Lvalue matrices are held by reference, rvalue matrices and nodes by value,
+        // so an expression never outlives the temporaries it was built from.
+        template<class T>
+        using operand_t = typename std::conditional<
+                std::is_same<std::decay_t<T>, Matrix>::value && std::is_lvalue_reference<T>::value,
+                const Matrix &,
+                std::decay_t<T>>::type;
+
+        template<class L, class R>
+        using enable_if_expressions = std::enable_if_t<
+                is_expression<std::decay_t<L>>::value && is_expression<std::decay_t<R>>::value>;
+
+        template<class L, class R>
+        using enable_if_lazy_involved = std::enable_if_t<
+                is_expression<std::decay_t<L>>::value && is_expression<std::decay_t<R>>::value &&
+                (is_lazy<std::decay_t<L>>::value || is_lazy<std::decay_t<R>>::value)>;
+
+        template<class E, class S>
+        using enable_if_scalable = std::enable_if_t<
+                is_expression<std::decay_t<E>>::value && std::is_arithmetic<S>::value>;
+
+        struct Scale {
+            double factor;
+
+            double operator()(double value) const;
+        };
+
+        double element(const Matrix &matrix, size_t row, size_t col);
+
+        template<class E>
+        double element(const E &expression, size_t row, size_t col);
+
+        // Element-wise node; operand sizes are checked when the node is built.
+        template<class L, class R, class Op>
+        class BinaryExpression {
+            L left;
+            R right;
+
+        public:
+
+            template<class LArg, class RArg>
+            BinaryExpression(LArg &&left, RArg &&right);
+
+            double operator()(size_t row, size_t col) const;
+
+            size_t getRowsNum() const;
+
+            size_t getColumnsNum() const;
+
+            const std::decay_t<L> &getLeft() const;
+
+            const std::decay_t<R> &getRight() const;
+        };
+
+        template<class E, class Op>
+        class UnaryExpression {
+            E operand;
+            Op op;
+
+        public:
+
+            template<class Arg>
+            UnaryExpression(Arg &&operand, Op op);
+
+            double operator()(size_t row, size_t col) const;
+
+            size_t getRowsNum() const;
+
+            size_t getColumnsNum() const;
+
+            const std::decay_t<E> &getOperand() const;
+
+            const Op &getOperation() const;
+        };
+
+        template<class L, class R>
+        using Sum = BinaryExpression<operand_t<L>, operand_t<R>, std::plus<double>>;
+
+        template<class L, class R>
+        using Difference = BinaryExpression<operand_t<L>, operand_t<R>, std::minus<double>>;
+
+        template<class E>
+        using Negated = UnaryExpression<operand_t<E>, std::negate<double>>;
+
+        template<class E>
+        using Scaled = UnaryExpression<operand_t<E>, Scale>;
+
+        const Matrix &evaluate(const Matrix &matrix);
+
+        template<class E>
+        Matrix evaluate(const E &expression);
+
+        // An operand of the matrix product as a strided view: matrices and views are read in
+        // place, other nodes are evaluated into `storage` first.
+        BasicMatrixView<const double> strided(const Matrix &matrix, Matrix &storage);
+
+        template<class T>
+        BasicMatrixView<const double> strided(const BasicMatrixView<T> &view, Matrix &storage);
+
+        template<class E>
+        BasicMatrixView<const double> strided(const E &expression, Matrix &storage);
+
+        // left * right through the GEMM kernel, which packs both operands straight from their strides.
+        Matrix multiply(const BasicMatrixView<const double> &left, const BasicMatrixView<const double> &right);
+
+        template<class L, class R>
+        bool equal(const L &left, const R &right);
+
+    }  // namespace expr
+
+    template<class L, class R, class = expr::enable_if_expressions<L, R>>
+    expr::Sum<L, R> operator+(L &&left, R &&right);
+
+    template<class L, class R, class = expr::enable_if_expressions<L, R>>
+    expr::Difference<L, R> operator-(L &&left, R &&right);
+
+    template<class E, class = std::enable_if_t<expr::is_expression<std::decay_t<E>>::value>>
+    expr::Negated<E> operator-(E &&operand);
+
+    template<class E, class S, class = expr::enable_if_scalable<E, S>>
+    expr::Scaled<E> operator*(E &&operand, S factor);
+
+    template<class S, class E, class = expr::enable_if_scalable<E, S>>
+    expr::Scaled<E> operator*(S factor, E &&operand);
+
+    // Views, including transposed-stride ones, are multiplied without being copied first.
+    template<class L, class R, class = expr::enable_if_lazy_involved<L, R>>
+    Matrix operator*(const L &left, const R &right);
+
+    template<class L, class R, class = expr::enable_if_lazy_involved<L, R>>
+    bool operator==(const L &left, const R &right);
+
+    template<class L, class R, class = expr::enable_if_lazy_involved<L, R>>
+    bool operator!=(const L &left, const R &right);
+
+}  // namespace task
@@ -0,0 +1,267 @@
+#include "matrix.h"
+
+namespace task {
+
+    inline double expr::Scale::operator()(double value) const {
+        return this->factor * value;
+    }
+
+    inline double expr::element(const Matrix &matrix, size_t row, size_t col) {
+        return matrix.data[row * matrix.stride + col];
+    }
+
+    template<class E>
+    double expr::element(const E &expression, size_t row, size_t col) {
+        return expression(row, col);
+    }
+
+    template<class L, class R, class Op>
+    template<class LArg, class RArg>
+    expr::BinaryExpression<L, R, Op>::BinaryExpression(LArg &&left, RArg &&right)
+            : left(std::forward<LArg>(left)), right(std::forward<RArg>(right)) {
+        if (this->left.getRowsNum() != this->right.getRowsNum() ||
+            this->left.getColumnsNum() != this->right.getColumnsNum()) {
+            throw SizeMismatchException();
+        }
+    }
+
+    template<class L, class R, class Op>
+    double expr::BinaryExpression<L, R, Op>::operator()(size_t row, size_t col) const {
+        return Op()(element(this->left, row, col), element(this->right, row, col));
+    }
+
+    template<class L, class R, class Op>
+    size_t expr::BinaryExpression<L, R, Op>::getRowsNum() const {
+        return this->left.getRowsNum();
+    }
+
+    template<class L, class R, class Op>
+    size_t expr::BinaryExpression<L, R, Op>::getColumnsNum() const {
+        return this->left.getColumnsNum();
+    }
+
+    template<class L, class R, class Op>
+    const std::decay_t<L> &expr::BinaryExpression<L, R, Op>::getLeft() const {
+        return this->left;
+    }
+
+    template<class L, class R, class Op>
+    const std::decay_t<R> &expr::BinaryExpression<L, R, Op>::getRight() const {
+        return this->right;
+    }
+
+    template<class E, class Op>
+    template<class Arg>
+    expr::UnaryExpression<E, Op>::UnaryExpression(Arg &&operand, Op op)
+            : operand(std::forward<Arg>(operand)), op(op) {
+    }
+
+    template<class E, class Op>
+    double expr::UnaryExpression<E, Op>::operator()(size_t row, size_t col) const {
+        return this->op(element(this->operand, row, col));
+    }
+
+    template<class E, class Op>
+    size_t expr::UnaryExpression<E, Op>::getRowsNum() const {
+        return this->operand.getRowsNum();
+    }
+
+    template<class E, class Op>
+    size_t expr::UnaryExpression<E, Op>::getColumnsNum() const {
+        return this->operand.getColumnsNum();
+    }
+
+    inline const Matrix &expr::evaluate(const Matrix &matrix) {
+        return matrix;
+    }
+
+    template<class E>
+    Matrix expr::evaluate(const E &expression) {
+        return Matrix(expression);
+    }
+
+    inline ConstMatrixView expr::strided(const Matrix &matrix, Matrix &) {
+        return matrix.view();
+    }
+
+    template<class T>
+    ConstMatrixView expr::strided(const BasicMatrixView<T> &view, Matrix &) {
+        return view;
+    }
+
+    template<class E>
+    ConstMatrixView expr::strided(const E &expression, Matrix &storage) {
+        storage = Matrix(expression);
+        return static_cast<const Matrix &>(storage).view();
+    }
+
+    template<class E, class Op>
+    const std::decay_t<E> &expr::UnaryExpression<E, Op>::getOperand() const {
+        return this->operand;
+    }
+
+    template<class E, class Op>
+    const Op &expr::UnaryExpression<E, Op>::getOperation() const {
+        return this->op;
+    }
+
+    template<class L, class R>
+    bool expr::equal(const L &left, const R &right) {
+        if (left.getRowsNum() != right.getRowsNum() || left.getColumnsNum() != right.getColumnsNum()) {
+            return false;
+        }
+
+        // Same rule as Matrix::operator==: lazy operands are evaluated once and compared in
+        // one vectorized pass.
+        const Matrix &left_matrix = expr::evaluate(left);
+        const Matrix &right_matrix = expr::evaluate(right);
+        return left_matrix.compare(right_matrix).equal;
+    }
+
+    template<class E, class>
+    Matrix::Matrix(const E &expression) : resource(getMatrixResource()) {
+        this->rows = expression.getRowsNum();
+        this->columns = expression.getColumnsNum();
+
+        allocate_memory();
+        assign(expression);
+    }
+
+    template<class E, class>
+    Matrix &Matrix::operator=(const E &expression) {
+        if (this->rows != expression.getRowsNum() || this->columns != expression.getColumnsNum()) {
+            return *this = Matrix(expression);
+        }
+
+        detach();
+        assign(expression);
+        return *this;
+    }
+
+    template<class E, class>
+    Matrix &Matrix::operator+=(const E &expression) {
+        check_size(expression.getRowsNum(), expression.getColumnsNum());
+        detach();
+
+        for (size_t i = 0; i < this->rows; i++) {
+            double *row = this->data + i * this->stride;
+            for (size_t j = 0; j < this->columns; j++) {
+                row[j] += expression(i, j);
+            }
+        }
+
+        return *this;
+    }
+
+    template<class E, class>
+    Matrix &Matrix::operator-=(const E &expression) {
+        check_size(expression.getRowsNum(), expression.getColumnsNum());
+        detach();
+
+        for (size_t i = 0; i < this->rows; i++) {
+            double *row = this->data + i * this->stride;
+            for (size_t j = 0; j < this->columns; j++) {
+                row[j] -= expression(i, j);
+            }
+        }
+
+        return *this;
+    }
+
+    // Every node is element-wise, so writing element (i, j) never clobbers an
+    // element the expression still has to read, even when *this is an operand.
+    template<class E>
+    void Matrix::assign(const E &expression) {
+        assign_elementwise(expression);
+    }
+
+    // Shapes that map onto a single SIMD kernel skip the generic per-element loop.
+    template<class L, class R>
+    void Matrix::assign(const expr::BinaryExpression<L, R, std::plus<double>> &expression) {
+        if constexpr (expr::is_leaf<L>::value && expr::is_leaf<R>::value) {
+            combine(expression.getLeft(), expression.getRight(), detail::add);
+        } else {
+            assign_elementwise(expression);
+        }
+    }
+
+    template<class L, class R>
+    void Matrix::assign(const expr::BinaryExpression<L, R, std::minus<double>> &expression) {
+        if constexpr (expr::is_leaf<L>::value && expr::is_leaf<R>::value) {
+            combine(expression.getLeft(), expression.getRight(), detail::subtract);
+        } else {
+            assign_elementwise(expression);
+        }
+    }
+
+    template<class E>
+    void Matrix::assign(const expr::UnaryExpression<E, expr::Scale> &expression) {
+        if constexpr (expr::is_leaf<E>::value) {
+            scale_from(expression.getOperand(), expression.getOperation().factor);
+        } else {
+            assign_elementwise(expression);
+        }
+    }
+
+    template<class E>
+    void Matrix::assign(const expr::UnaryExpression<E, std::negate<double>> &expression) {
+        if constexpr (expr::is_leaf<E>::value) {
+            scale_from(expression.getOperand(), -1.0);
+        } else {
+            assign_elementwise(expression);
+        }
+    }
+
+    template<class E>
+    void Matrix::assign_elementwise(const E &expression) {
+        for (size_t i = 0; i < this->rows; i++) {
+            double *row = this->data + i * this->stride;
+            for (size_t j = 0; j < this->columns; j++) {
+                row[j] = expression(i, j);
+            }
+        }
+    }
+
+    template<class L, class R, class>
+    expr::Sum<L, R> operator+(L &&left, R &&right) {
+        return expr::Sum<L, R>(std::forward<L>(left), std::forward<R>(right));
+    }
+
+    template<class L, class R, class>
+    expr::Difference<L, R> operator-(L &&left, R &&right) {
+        return expr::Difference<L, R>(std::forward<L>(left), std::forward<R>(right));
+    }
+
+    template<class E, class>
+    expr::Negated<E> operator-(E &&operand) {
+        return expr::Negated<E>(std::forward<E>(operand), std::negate<double>());
+    }
+
+    template<class E, class S, class>
+    expr::Scaled<E> operator*(E &&operand, S factor) {
+        return expr::Scaled<E>(std::forward<E>(operand), expr::Scale{static_cast<double>(factor)});
+    }
+
+    template<class S, class E, class>
+    expr::Scaled<E> operator*(S factor, E &&operand) {
+        return expr::Scaled<E>(std::forward<E>(operand), expr::Scale{static_cast<double>(factor)});
+    }
+
+    template<class L, class R, class>
+    Matrix operator*(const L &left, const R &right) {
+        Matrix left_storage;
+        Matrix right_storage;
+        return expr::multiply(expr::strided(left, left_storage), expr::strided(right, right_storage));
+    }
+
+    template<class L, class R, class>
+    bool operator==(const L &left, const R &right) {
+        return expr::equal(left, right);
+    }
+
+    template<class L, class R, class>
+    bool operator!=(const L &left, const R &right) {
+        return !expr::equal(left, right);
+    }
+
+}  // namespace task
@@ -0,0 +1,269 @@
+#include "matrix_io.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace task;
+
+namespace {
+
+    const char MAGIC[4] = {'M', 'T', 'R', 'X'};
+    const uint8_t VERSION = 1;
+    const uint8_t DTYPE_FLOAT64 = 1;
+    const uint16_t ENDIAN_MARKER = 0x0102;
+    const uint16_t SWAPPED_ENDIAN_MARKER = 0x0201;
+
+    struct Header {
+        char magic[4];
+        uint8_t version;
+        uint8_t dtype;
+        uint16_t endian;
+        uint32_t reserved;
+        uint64_t rows;
+        uint64_t columns;
+        uint64_t checksum;
+        uint8_t padding[24];
+    };
+
+    static_assert(sizeof(Header) == 64, "binary matrix header must be 64 bytes");
+
+    uint64_t swap_bytes(uint64_t value) {
+        return __builtin_bswap64(value);
+    }
+
+    // FNV-1a over 64-bit words rather than bytes, so hashing keeps up with the disk.
+    class Checksum {
+        uint64_t hash = 0xcbf29ce484222325ull;
+
+    public:
+
+        void update(const void *words, size_t count, bool swapped) {
+            const unsigned char *bytes = static_cast<const unsigned char *>(words);
+            for (size_t i = 0; i < count; i++) {
+                uint64_t word;
+                std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+                this->hash = (this->hash ^ (swapped ? swap_bytes(word) : word)) * 0x100000001b3ull;
+            }
+        }
+
+        uint64_t value() const {
+            return this->hash;
+        }
+    };
+
+    [[noreturn]] void throw_errno() {
+        throw std::system_error(errno, std::generic_category());
+    }
+
+    // Returns whether the file was written with the opposite byte order.
+    bool check_header(Header &header) {
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.version != VERSION || header.dtype != DTYPE_FLOAT64) {
+            throw MatrixFormatException();
+        }
+
+        if (header.endian == ENDIAN_MARKER) {
+            return false;
+        }
+        if (header.endian != SWAPPED_ENDIAN_MARKER) {
+            throw MatrixFormatException();
+        }
+
+        header.rows = swap_bytes(header.rows);
+        header.columns = swap_bytes(header.columns);
+        header.checksum = swap_bytes(header.checksum);
+        return true;
+    }
+
+    size_t payload_count(const Header &header) {
+        if (header.columns != 0 && header.rows > SIZE_MAX / sizeof(double) / header.columns) {
+            throw MatrixFormatException();
+        }
+        return header.rows * header.columns;
+    }
+
+    // Whether a file of `length` bytes holds the payload its header claims. Compares element
+    // counts rather than byte totals, which a hostile header could make wrap around.
+    bool payload_fits(const Header &header, size_t length) {
+        return length >= sizeof(Header) && payload_count(header) <= (length - sizeof(Header)) / sizeof(double);
+    }
+
+}  // namespace
+
+void task::saveBinary(const Matrix &matrix, const std::string &path) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        throw_errno();
+    }
+
+    size_t rows = matrix.getRowsNum();
+    size_t columns = matrix.getColumnsNum();
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.dtype = DTYPE_FLOAT64;
+    header.endian = ENDIAN_MARKER;
+    header.rows = rows;
+    header.columns = columns;
+
+    // Rows of an empty-width matrix cannot be indexed and contribute nothing anyway.
+    size_t stored_rows = columns == 0 ? 0 : rows;
+
+    Checksum checksum;
+    for (size_t i = 0; i < stored_rows; i++) {
+        checksum.update(matrix[i], columns, false);
+    }
+    header.checksum = checksum.value();
+
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (size_t i = 0; i < stored_rows; i++) {
+        output.write(reinterpret_cast<const char *>(matrix[i]), columns * sizeof(double));
+    }
+
+    if (!output.flush()) {
+        throw_errno();
+    }
+}
+
+Matrix task::loadBinary(const std::string &path) {
+    std::ifstream input(path, std::ios::binary | std::ios::ate);
+    if (!input) {
+        throw_errno();
+    }
+    size_t length = static_cast<size_t>(input.tellg());
+    input.seekg(0);
+
+    Header header;
+    if (!input.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+        throw MatrixFormatException();
+    }
+    bool swapped = check_header(header);
+
+    // A corrupt header must not get as far as allocating the matrix it claims.
+    if (!payload_fits(header, length)) {
+        throw MatrixFormatException();
+    }
+
+    Matrix matrix(header.rows, header.columns);
+    Checksum checksum;
+
+    for (size_t i = 0; header.columns != 0 && i < header.rows; i++) {
+        double *row = matrix[i];
+        if (!input.read(reinterpret_cast<char *>(row), header.columns * sizeof(double))) {
+            throw MatrixFormatException();
+        }
+        checksum.update(row, header.columns, swapped);
+
+        if (swapped) {
+            for (size_t j = 0; j < header.columns; j++) {
+                uint64_t word;
+                std::memcpy(&word, row + j, sizeof(word));
+                word = swap_bytes(word);
+                std::memcpy(row + j, &word, sizeof(word));
+            }
+        }
+    }
+
+    if (checksum.value() != header.checksum) {
+        throw MatrixFormatException();
+    }
+
+    return matrix;
+}
+
+MappedMatrix::MappedMatrix(const std::string &path) : mapping(nullptr), length(0), rows(0), columns(0), checksum(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw_errno();
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category());
+    }
+
+    this->length = static_cast<size_t>(info.st_size);
+    if (this->length < sizeof(Header)) {
+        ::close(fd);
+        throw MatrixFormatException();
+    }
+
+    this->mapping = ::mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    ::close(fd);
+    if (this->mapping == MAP_FAILED) {
+        this->mapping = nullptr;
+        throw std::system_error(error, std::generic_category());
+    }
+
+    Header header;
+    std::memcpy(&header, this->mapping, sizeof(header));
+
+    try {
+        if (check_header(header) || !payload_fits(header, this->length)) {
+            throw MatrixFormatException();
+        }
+    } catch (...) {
+        ::munmap(this->mapping, this->length);
+        throw;
+    }
+
+    this->rows = header.rows;
+    this->columns = header.columns;
+    this->checksum = header.checksum;
+}
+
+MappedMatrix::MappedMatrix(MappedMatrix &&other) noexcept
+        : mapping(other.mapping), length(other.length), rows(other.rows),
+          columns(other.columns), checksum(other.checksum) {
+    other.mapping = nullptr;
+    other.length = 0;
+    other.rows = 0;
+    other.columns = 0;
+}
+
+MappedMatrix &MappedMatrix::operator=(MappedMatrix &&other) noexcept {
+    std::swap(this->mapping, other.mapping);
+    std::swap(this->length, other.length);
+    std::swap(this->rows, other.rows);
+    std::swap(this->columns, other.columns);
+    std::swap(this->checksum, other.checksum);
+    return *this;
+}
+
+MappedMatrix::~MappedMatrix() {
+    if (this->mapping != nullptr) {
+        ::munmap(this->mapping, this->length);
+    }
+}
+
+const double *MappedMatrix::values() const {
+    return reinterpret_cast<const double *>(static_cast<const char *>(this->mapping) + sizeof(Header));
+}
+
+ConstMatrixView MappedMatrix::view() const {
+    return ConstMatrixView(values(), this->rows, this->columns, this->columns, 1);
+}
+
+bool MappedMatrix::verify() const {
+    Checksum checksum;
+    checksum.update(values(), this->rows * this->columns, false);
+    return checksum.value() == this->checksum;
+}
+
+size_t MappedMatrix::getRowsNum() const {
+    return this->rows;
+}
+
+size_t MappedMatrix::getColumnsNum() const {
+    return this->columns;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "matrix.h"
+
+
+namespace task {
+
+    class MatrixFormatException : public std::exception {
+    };
+
+    // Binary layout: a 64-byte header followed by rows * cols float64 values, row-major,
+    // in the byte order of the writer. The header records magic "MTRX", version, dtype,
+    // an endianness marker, the dimensions and a checksum of the payload.
+    // I/O failures throw std::system_error, malformed files MatrixFormatException.
+    void saveBinary(const Matrix &matrix, const std::string &path);
+
+    // Reads and verifies the whole file, byte-swapping if it was written on the other endianness.
+    Matrix loadBinary(const std::string &path);
+
+    // Zero-copy read-only access to a file in the binary format through mmap. Only the
+    // header is checked on open, so opening costs the same for any size; verify() scans
+    // the payload against the checksum. The file must use the host byte order.
+    class MappedMatrix {
+        void *mapping;
+        size_t length;
+        size_t rows;
+        size_t columns;
+        uint64_t checksum;
+
+        const double *values() const;
+
+    public:
+
+        explicit MappedMatrix(const std::string &path);
+
+        MappedMatrix(const MappedMatrix &) = delete;
+
+        MappedMatrix &operator=(const MappedMatrix &) = delete;
+
+        MappedMatrix(MappedMatrix &&other) noexcept;
+
+        MappedMatrix &operator=(MappedMatrix &&other) noexcept;
+
+        ~MappedMatrix();
+
+        ConstMatrixView view() const;
+
+        bool verify() const;
+
+        size_t getRowsNum() const;
+
+        size_t getColumnsNum() const;
+    };
+
+}  // namespace task
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+
+namespace task {
+
+    // Non-owning strided window over matrix storage: element (i, j) lives at
+    // data[i * row_stride + j * column_stride]. Rows, columns, blocks and the
+    // diagonal are all expressed this way. The viewed matrix must outlive the view
+    // and must not be resized while it is in use.
+    template<class T>
+    class BasicMatrixView {
+        T *data;
+        size_t rows;
+        size_t columns;
+        size_t row_stride;
+        size_t column_stride;
+
+        template<class>
+        friend class BasicMatrixView;
+
+    public:
+
+        BasicMatrixView(T *data, size_t rows, size_t columns, size_t row_stride, size_t column_stride);
+
+        template<class U, class = std::enable_if_t<std::is_convertible<U *, T *>::value>>
+        BasicMatrixView(const BasicMatrixView<U> &other);
+
+        T &operator()(size_t row, size_t col) const;
+
+        T &get(size_t row, size_t col) const;
+
+        BasicMatrixView block(size_t row, size_t col, size_t rows, size_t cols) const;
+
+        BasicMatrixView row(size_t row) const;
+
+        BasicMatrixView column(size_t col) const;
+
+        size_t getRowsNum() const;
+
+        size_t getColumnsNum() const;
+
+        size_t getRowStride() const;
+
+        size_t getColumnStride() const;
+
+        T *begin() const;
+
+        // Writes an expression of the same shape through the view; it must not overlap the view
+        // other than element for element.
+        template<class E>
+        void assign(const E &expression) const;
+    };
+
+    using MatrixView = BasicMatrixView<double>;
+
+    using ConstMatrixView = BasicMatrixView<const double>;
+
+}  // namespace task
@@ -0,0 +1,90 @@
+#include "matrix.h"
+
+namespace task {
+
+    template<class T>
+    BasicMatrixView<T>::BasicMatrixView(T *data, size_t rows, size_t columns, size_t row_stride, size_t column_stride)
+            : data(data), rows(rows), columns(columns), row_stride(row_stride), column_stride(column_stride) {
+    }
+
+    template<class T>
+    template<class U, class>
+    BasicMatrixView<T>::BasicMatrixView(const BasicMatrixView<U> &other)
+            : data(other.data), rows(other.rows), columns(other.columns),
+              row_stride(other.row_stride), column_stride(other.column_stride) {
+    }
+
+    template<class T>
+    T &BasicMatrixView<T>::operator()(size_t row, size_t col) const {
+        return this->data[row * this->row_stride + col * this->column_stride];
+    }
+
+    template<class T>
+    T &BasicMatrixView<T>::get(size_t row, size_t col) const {
+        if (row >= this->rows || col >= this->columns) {
+            throw OutOfBoundsException();
+        }
+        return (*this)(row, col);
+    }
+
+    template<class T>
+    BasicMatrixView<T> BasicMatrixView<T>::block(size_t row, size_t col, size_t rows, size_t cols) const {
+        if (row + rows > this->rows || col + cols > this->columns) {
+            throw OutOfBoundsException();
+        }
+        return BasicMatrixView(this->data + row * this->row_stride + col * this->column_stride,
+                               rows, cols, this->row_stride, this->column_stride);
+    }
+
+    template<class T>
+    BasicMatrixView<T> BasicMatrixView<T>::row(size_t row) const {
+        return block(row, 0, 1, this->columns);
+    }
+
+    template<class T>
+    BasicMatrixView<T> BasicMatrixView<T>::column(size_t col) const {
+        return block(0, col, this->rows, 1);
+    }
+
+    template<class T>
+    size_t BasicMatrixView<T>::getRowsNum() const {
+        return this->rows;
+    }
+
+    template<class T>
+    size_t BasicMatrixView<T>::getColumnsNum() const {
+        return this->columns;
+    }
+
+    template<class T>
+    size_t BasicMatrixView<T>::getRowStride() const {
+        return this->row_stride;
+    }
+
+    template<class T>
+    size_t BasicMatrixView<T>::getColumnStride() const {
+        return this->column_stride;
+    }
+
+    template<class T>
+    T *BasicMatrixView<T>::begin() const {
+        return this->data;
+    }
+
+    template<class T>
+    template<class E>
+    void BasicMatrixView<T>::assign(const E &expression) const {
+        static_assert(!std::is_const<T>::value, "cannot assign through a ConstMatrixView");
+
+        if (expression.getRowsNum() != this->rows || expression.getColumnsNum() != this->columns) {
+            throw SizeMismatchException();
+        }
+
+        for (size_t i = 0; i < this->rows; i++) {
+            for (size_t j = 0; j < this->columns; j++) {
+                (*this)(i, j) = expr::element(expression, i, j);
+            }
+        }
+    }
+
+}  // namespace task
@@ -0,0 +1,281 @@
+#include "matrix.h"
+#include "kernels.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+using namespace task;
+
+namespace {
+
+    // Reductions are split into pool tasks of about this many elements.
+    const size_t CHUNK = PARALLEL_THRESHOLD;
+
+    // Pairwise summation hands stretches up to this long to the SIMD kernel as they are.
+    const size_t PAIRWISE_BLOCK = 256;
+
+    // Column sums add rows pairwise down to blocks of this many rows.
+    const size_t PAIRWISE_ROWS = 16;
+
+    // Column-wise tasks take at least this many columns so that rows are read in whole lines.
+    const size_t MIN_COLUMNS = 64;
+
+    // Sums of squares below this may have lost digits to subnormals, so norm() rescales them.
+    const double SQUARES_MIN = std::numeric_limits<double>::min() / std::numeric_limits<double>::epsilon();
+
+    struct CompensatedSum {
+        double total = 0.0;
+        double correction = 0.0;
+
+        void add(double value) {
+            double y = value - correction;
+            double t = total + y;
+            correction = (t - total) - y;
+            total = t;
+        }
+
+        double value() const {
+            return total;
+        }
+    };
+
+    struct Minimum {
+        double result = HUGE_VAL;
+
+        void add(double value) {
+            result = value < result ? value : result;
+        }
+
+        double value() const {
+            return result;
+        }
+    };
+
+    struct Maximum {
+        double result = -HUGE_VAL;
+
+        void add(double value) {
+            result = value > result ? value : result;
+        }
+
+        double value() const {
+            return result;
+        }
+    };
+
+    // The largest of non-negative values, or NaN once any of them is NaN. Starts at 0 so
+    // that the norms of an empty matrix are 0.
+    struct Largest {
+        double result = 0.0;
+
+        void add(double value) {
+            result = value > result || value != value ? value : result;
+        }
+
+        double value() const {
+            return result;
+        }
+    };
+
+    double pairwise_sum(const double *a, size_t n) {
+        if (n <= PAIRWISE_BLOCK) {
+            return detail::sum(a, n);
+        }
+        size_t half = (n / 2 + PAIRWISE_BLOCK - 1) / PAIRWISE_BLOCK * PAIRWISE_BLOCK;
+        return pairwise_sum(a, half) + pairwise_sum(a + half, n - half);
+    }
+
+    double sum_of(const double *a, size_t n, Summation mode) {
+        switch (mode) {
+            case Summation::Naive:
+                return detail::sum(a, n);
+            case Summation::Kahan:
+                return detail::sum_kahan(a, n);
+            default:
+                return pairwise_sum(a, n);
+        }
+    }
+
+    size_t chunk_length(size_t width) {
+        return std::max<size_t>(1, CHUNK / std::max<size_t>(1, width));
+    }
+
+    // Folds kernel(row, columns) over every row of a strided block into an Accumulator. When
+    // `per_row` is false and the rows are contiguous, the kernel runs over chunk-sized
+    // stretches of the whole block instead.
+    template<class Accumulator, class Kernel>
+    double reduce(const double *data, size_t rows, size_t columns, size_t stride, bool per_row, Kernel kernel) {
+        bool flat = !per_row && (stride == columns || rows <= 1);
+        size_t count = flat ? rows * columns : rows;
+        size_t length = chunk_length(flat ? 1 : columns);
+
+        auto partial = [&](size_t begin, size_t end) {
+            if (flat) {
+                return kernel(data + begin, end - begin);
+            }
+            Accumulator part;
+            for (size_t i = begin; i < end; i++) {
+                part.add(kernel(data + i * stride, columns));
+            }
+            return part.value();
+        };
+
+        Accumulator total;
+        if (count <= length) {
+            if (count > 0) {
+                total.add(partial(0, count));
+            }
+            return total.value();
+        }
+
+        std::vector<double> partials((count + length - 1) / length);
+        parallel_ranges(count, length, rows * columns, [&](size_t chunk, size_t begin, size_t end) {
+            partials[chunk] = partial(begin, end);
+        });
+        for (double value : partials) {
+            total.add(value);
+        }
+        return total.value();
+    }
+
+    // out = the column sums of `rows` rows of `length` elements, added pairwise over the rows.
+    // scratch has room for `length` doubles per level of recursion.
+    void pairwise_column_sums(const double *a, size_t rows, size_t length, size_t stride,
+                              double *out, double *scratch) {
+        if (rows <= PAIRWISE_ROWS) {
+            std::copy(a, a + length, out);
+            for (size_t i = 1; i < rows; i++) {
+                detail::add(out, a + i * stride, out, length);
+            }
+            return;
+        }
+        size_t half = rows / 2;
+        pairwise_column_sums(a, half, length, stride, out, scratch + length);
+        pairwise_column_sums(a + half * stride, rows - half, length, stride, scratch, scratch + length);
+        detail::add(out, scratch, out, length);
+    }
+
+    void column_sums(const double *a, size_t rows, size_t length, size_t stride, double *out, Summation mode) {
+        if (rows == 0) {
+            std::fill(out, out + length, 0.0);
+            return;
+        }
+
+        if (mode == Summation::Naive) {
+            std::copy(a, a + length, out);
+            for (size_t i = 1; i < rows; i++) {
+                detail::add(out, a + i * stride, out, length);
+            }
+        } else if (mode == Summation::Kahan) {
+            std::vector<double> correction(length, 0.0);
+            double *c = correction.data();
+            std::fill(out, out + length, 0.0);
+            for (size_t i = 0; i < rows; i++) {
+                const double *row = a + i * stride;
+                for (size_t j = 0; j < length; j++) {
+                    double y = row[j] - c[j];
+                    double t = out[j] + y;
+                    c[j] = (t - out[j]) - y;
+                    out[j] = t;
+                }
+            }
+        } else {
+            size_t levels = 1;
+            for (size_t block = PAIRWISE_ROWS; block < rows; block *= 2) {
+                levels++;
+            }
+            std::vector<double> scratch(levels * length);
+            pairwise_column_sums(a, rows, length, stride, out, scratch.data());
+        }
+    }
+
+}  // namespace
+
+double Matrix::sum(Summation mode) const {
+    return reduce<CompensatedSum>(this->data, this->rows, this->columns, this->stride, false,
+                                  [mode](const double *a, size_t n) {
+                                      return sum_of(a, n, mode);
+                                  });
+}
+
+std::vector<double> Matrix::rowSums(Summation mode) const {
+    std::vector<double> result(this->rows);
+    size_t elements = this->rows * this->columns;
+    parallel_ranges(this->rows, chunk_length(this->columns), elements, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            result[i] = sum_of(this->data + i * this->stride, this->columns, mode);
+        }
+    });
+    return result;
+}
+
+std::vector<double> Matrix::columnSums(Summation mode) const {
+    std::vector<double> result(this->columns);
+    size_t length = std::max(MIN_COLUMNS, chunk_length(this->rows));
+    size_t elements = this->rows * this->columns;
+    parallel_ranges(this->columns, length, elements, [&](size_t, size_t begin, size_t end) {
+        column_sums(this->data + begin, this->rows, end - begin, this->stride, result.data() + begin, mode);
+    });
+    return result;
+}
+
+double Matrix::min() const {
+    return reduce<Minimum>(this->data, this->rows, this->columns, this->stride, false, detail::min);
+}
+
+double Matrix::max() const {
+    return reduce<Maximum>(this->data, this->rows, this->columns, this->stride, false, detail::max);
+}
+
+double Matrix::maxAbs() const {
+    return reduce<Largest>(this->data, this->rows, this->columns, this->stride, false, detail::max_abs);
+}
+
+double Matrix::norm() const {
+    double squares = reduce<CompensatedSum>(this->data, this->rows, this->columns, this->stride, false,
+                                            detail::sum_squares);
+    if (squares < HUGE_VAL && squares >= SQUARES_MIN) {
+        return std::sqrt(squares);
+    }
+
+    // The squares overflowed (the compensated sum of infinities is NaN), met a NaN, or fell where
+    // subnormals lose digits. Like dnrm2, sum them again scaled by a power of two near
+    // 1 / maxAbs(), which is exact and keeps them in range.
+    double largest = this->maxAbs();
+    if (largest == 0.0 || largest == HUGE_VAL || largest != largest) {
+        return largest;
+    }
+    double scale = std::ldexp(1.0, -std::ilogb(largest));
+    double scaled = reduce<CompensatedSum>(this->data, this->rows, this->columns, this->stride, false,
+                                           [scale](const double *a, size_t n) {
+                                               double sum = 0.0;
+                                               for (size_t i = 0; i < n; i++) {
+                                                   sum += (a[i] * scale) * (a[i] * scale);
+                                               }
+                                               return sum;
+                                           });
+    return std::sqrt(scaled) / scale;
+}
+
+double Matrix::norm1() const {
+    std::vector<double> sums(this->columns, 0.0);
+    size_t length = std::max(MIN_COLUMNS, chunk_length(this->rows));
+    size_t elements = this->rows * this->columns;
+    parallel_ranges(this->columns, length, elements, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = 0; i < this->rows; i++) {
+            detail::add_abs(this->data + i * this->stride + begin, sums.data() + begin, end - begin);
+        }
+    });
+
+    Largest result;
+    for (double sum : sums) {
+        result.add(sum);
+    }
+    return result.value();
+}
+
+double Matrix::normInf() const {
+    return reduce<Largest>(this->data, this->rows, this->columns, this->stride, true, detail::sum_abs);
+}
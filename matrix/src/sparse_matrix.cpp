@@ -0,0 +1,224 @@
+#include "sparse_matrix.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+
+using namespace task;
+
+namespace {
+
+    // Calls body(begin, end) for the row ranges between consecutive bounds, one task each.
+    void run_chunks(const std::vector<size_t> &bounds, size_t work, const std::function<void(size_t, size_t)> &body) {
+        parallel_ranges(bounds.size() - 1, 1, work, [&](size_t chunk, size_t, size_t) {
+            body(bounds[chunk], bounds[chunk + 1]);
+        });
+    }
+
+}  // namespace
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols)
+        : rows(rows), columns(cols), row_offsets(rows + 1, 0) {
+}
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols, std::vector<Triplet> triplets)
+        : SparseMatrix(rows, cols) {
+    for (const Triplet &triplet : triplets) {
+        if (triplet.row >= rows || triplet.col >= cols) {
+            throw OutOfBoundsException();
+        }
+    }
+
+    std::sort(triplets.begin(), triplets.end(), [](const Triplet &a, const Triplet &b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+
+    for (size_t i = 0; i < triplets.size(); i++) {
+        const Triplet &triplet = triplets[i];
+        if (i > 0 && triplets[i - 1].row == triplet.row && triplets[i - 1].col == triplet.col) {
+            this->values.back() += triplet.value;
+            continue;
+        }
+        this->column_indices.push_back(triplet.col);
+        this->values.push_back(triplet.value);
+        this->row_offsets[triplet.row + 1]++;
+    }
+
+    std::partial_sum(this->row_offsets.begin(), this->row_offsets.end(), this->row_offsets.begin());
+}
+
+SparseMatrix::SparseMatrix(const Matrix &matrix, double tolerance)
+        : SparseMatrix(matrix.getRowsNum(), matrix.getColumnsNum()) {
+    for (size_t i = 0; i < this->rows; i++) {
+        const double *row = matrix[i];
+        for (size_t j = 0; j < this->columns; j++) {
+            if (std::fabs(row[j]) > tolerance) {
+                this->column_indices.push_back(j);
+                this->values.push_back(row[j]);
+            }
+        }
+        this->row_offsets[i + 1] = this->values.size();
+    }
+}
+
+Matrix SparseMatrix::toMatrix() const {
+    Matrix matrix(this->rows, this->columns);
+
+    for (size_t i = 0; i < this->rows; i++) {
+        double *row = matrix[i];
+        std::fill(row, row + this->columns, 0.0);
+        for (size_t p = this->row_offsets[i]; p < this->row_offsets[i + 1]; p++) {
+            row[this->column_indices[p]] = this->values[p];
+        }
+    }
+
+    return matrix;
+}
+
+double SparseMatrix::get(size_t row, size_t col) const {
+    if (row >= this->rows || col >= this->columns) {
+        throw OutOfBoundsException();
+    }
+
+    auto begin = this->column_indices.begin() + this->row_offsets[row];
+    auto end = this->column_indices.begin() + this->row_offsets[row + 1];
+    auto found = std::lower_bound(begin, end, col);
+
+    return found != end && *found == col ? this->values[found - this->column_indices.begin()] : 0.0;
+}
+
+size_t SparseMatrix::getRowsNum() const {
+    return this->rows;
+}
+
+size_t SparseMatrix::getColumnsNum() const {
+    return this->columns;
+}
+
+size_t SparseMatrix::nonZeros() const {
+    return this->values.size();
+}
+
+std::vector<size_t> SparseMatrix::partition_rows() const {
+    size_t chunks = std::max<size_t>(1, std::min(this->rows, get_num_threads() * 4));
+    size_t per_chunk = (nonZeros() + chunks - 1) / chunks;
+
+    std::vector<size_t> bounds{0};
+    for (size_t i = 0; i < this->rows; i++) {
+        if (this->row_offsets[i + 1] >= bounds.size() * per_chunk && bounds.size() < chunks) {
+            bounds.push_back(i + 1);
+        }
+    }
+    if (bounds.back() != this->rows) {
+        bounds.push_back(this->rows);
+    }
+
+    return bounds;
+}
+
+std::vector<double> SparseMatrix::operator*(const std::vector<double> &vector) const {
+    if (vector.size() != this->columns) {
+        throw SizeMismatchException();
+    }
+
+    std::vector<double> result(this->rows, 0.0);
+    run_chunks(partition_rows(), nonZeros(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            double sum = 0.0;
+            for (size_t p = this->row_offsets[i]; p < this->row_offsets[i + 1]; p++) {
+                sum += this->values[p] * vector[this->column_indices[p]];
+            }
+            result[i] = sum;
+        }
+    });
+
+    return result;
+}
+
+Matrix SparseMatrix::operator*(const Matrix &matrix) const {
+    if (matrix.getRowsNum() != this->columns) {
+        throw SizeMismatchException();
+    }
+
+    size_t n = matrix.getColumnsNum();
+    Matrix result(this->rows, n);
+
+    run_chunks(partition_rows(), nonZeros() * n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            double *out = result[i];
+            std::fill(out, out + n, 0.0);
+            for (size_t p = this->row_offsets[i]; p < this->row_offsets[i + 1]; p++) {
+                double value = this->values[p];
+                const double *in = matrix[this->column_indices[p]];
+                for (size_t j = 0; j < n; j++) {
+                    out[j] += value * in[j];
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+// Gustavson's row-by-row product with a dense accumulator and a marker per column.
+SparseMatrix SparseMatrix::operator*(const SparseMatrix &matrix) const {
+    if (matrix.rows != this->columns) {
+        throw SizeMismatchException();
+    }
+
+    SparseMatrix result(this->rows, matrix.columns);
+    std::vector<double> accumulator(matrix.columns, 0.0);
+    std::vector<size_t> marker(matrix.columns, static_cast<size_t>(-1));
+    std::vector<size_t> row_columns;
+
+    for (size_t i = 0; i < this->rows; i++) {
+        row_columns.clear();
+
+        for (size_t p = this->row_offsets[i]; p < this->row_offsets[i + 1]; p++) {
+            size_t k = this->column_indices[p];
+            double value = this->values[p];
+
+            for (size_t q = matrix.row_offsets[k]; q < matrix.row_offsets[k + 1]; q++) {
+                size_t j = matrix.column_indices[q];
+                if (marker[j] != i) {
+                    marker[j] = i;
+                    accumulator[j] = 0.0;
+                    row_columns.push_back(j);
+                }
+                accumulator[j] += value * matrix.values[q];
+            }
+        }
+
+        std::sort(row_columns.begin(), row_columns.end());
+        for (size_t j : row_columns) {
+            result.column_indices.push_back(j);
+            result.values.push_back(accumulator[j]);
+        }
+        result.row_offsets[i + 1] = result.values.size();
+    }
+
+    return result;
+}
+
+SparseMatrix SparseMatrix::transposed() const {
+    SparseMatrix result(this->columns, this->rows);
+    result.column_indices.resize(nonZeros());
+    result.values.resize(nonZeros());
+
+    for (size_t j : this->column_indices) {
+        result.row_offsets[j + 1]++;
+    }
+    std::partial_sum(result.row_offsets.begin(), result.row_offsets.end(), result.row_offsets.begin());
+
+    std::vector<size_t> next(result.row_offsets.begin(), result.row_offsets.end() - 1);
+    for (size_t i = 0; i < this->rows; i++) {
+        for (size_t p = this->row_offsets[i]; p < this->row_offsets[i + 1]; p++) {
+            size_t position = next[this->column_indices[p]]++;
+            result.column_indices[position] = i;
+            result.values[position] = this->values[p];
+        }
+    }
+
+    return result;
+}
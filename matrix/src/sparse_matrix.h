@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "matrix.h"
+
+
+namespace task {
+
+    struct Triplet {
+        size_t row;
+        size_t col;
+        double value;
+    };
+
+    // Compressed sparse row matrix: memory is O(rows + non-zeros). Column indices
+    // within a row are kept sorted and unique.
+    class SparseMatrix {
+        size_t rows;
+        size_t columns;
+        std::vector<size_t> row_offsets;
+        std::vector<size_t> column_indices;
+        std::vector<double> values;
+
+        // Splits rows into ranges holding roughly equal numbers of non-zeros, one task each.
+        std::vector<size_t> partition_rows() const;
+
+    public:
+
+        SparseMatrix(size_t rows, size_t cols);
+
+        // Duplicate coordinates are summed.
+        SparseMatrix(size_t rows, size_t cols, std::vector<Triplet> triplets);
+
+        // Keeps the elements with |value| > tolerance.
+        explicit SparseMatrix(const Matrix &matrix, double tolerance = 0.0);
+
+        Matrix toMatrix() const;
+
+        double get(size_t row, size_t col) const;
+
+        size_t getRowsNum() const;
+
+        size_t getColumnsNum() const;
+
+        size_t nonZeros() const;
+
+        // Products run on the shared thread pool once they are large enough; every
+        // output row is produced by one task, so results do not depend on the thread count.
+        std::vector<double> operator*(const std::vector<double> &vector) const;
+
+        Matrix operator*(const Matrix &matrix) const;
+
+        SparseMatrix operator*(const SparseMatrix &matrix) const;
+
+        SparseMatrix transposed() const;
+    };
+
+}  // namespace task
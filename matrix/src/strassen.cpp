@@ -0,0 +1,153 @@
+#include "strassen.h"
+#include "gemm.h"
+#include "kernels.h"
+#include <cmath>
+#include <limits>
+#include <memory_resource>
+#include <algorithm>
+
+using namespace task;
+
+namespace {
+
+    using Buffer = std::pmr::vector<double>;
+
+    // Scratch buffers come from the same resource as Matrix buffers, so MatrixResourceScope
+    // covers them as well.
+    std::pmr::memory_resource *scratch_resource() {
+        std::pmr::memory_resource *resource = getMatrixResource();
+        return resource ? resource : std::pmr::new_delete_resource();
+    }
+
+    struct Plan {
+        size_t depth;
+        size_t leaf;
+        size_t padded;
+    };
+
+    Plan make_plan(size_t n, size_t crossover) {
+        crossover = std::max<size_t>(crossover, 1);
+
+        Plan plan{0, n, n};
+        while (plan.leaf > crossover) {
+            plan.depth++;
+            plan.leaf = (plan.leaf + 1) / 2;
+        }
+        plan.padded = plan.leaf << plan.depth;
+        return plan;
+    }
+
+    void add(size_t n, const double *a, size_t lda, const double *b, size_t ldb, double *c, size_t ldc) {
+        for (size_t i = 0; i < n; i++) {
+            detail::add(a + i * lda, b + i * ldb, c + i * ldc, n);
+        }
+    }
+
+    void subtract(size_t n, const double *a, size_t lda, const double *b, size_t ldb, double *c, size_t ldc) {
+        for (size_t i = 0; i < n; i++) {
+            detail::subtract(a + i * lda, b + i * ldb, c + i * ldc, n);
+        }
+    }
+
+    // C = A * B for n x n blocks. Uses the two-temporary schedule of Boyer, Dumas, Pernet and
+    // Zhou ("Memory efficient scheduling of Strassen-Winograd's matrix multiplication
+    // algorithm", 2009): X holds the A-side sums, Y the B-side sums, and the C quadrants
+    // double as storage for the partial products. workspace holds X and Y for this level
+    // followed by the workspace of the deeper levels.
+    void multiply(size_t n, size_t depth,
+                  const double *a, size_t lda, const double *b, size_t ldb, double *c, size_t ldc,
+                  double *workspace) {
+        if (depth == 0) {
+            detail::gemm(n, n, n, 1.0, a, lda, b, ldb, 0.0, c, ldc);
+            return;
+        }
+
+        size_t h = n / 2;
+        const double *a11 = a, *a12 = a + h, *a21 = a + h * lda, *a22 = a + h * lda + h;
+        const double *b11 = b, *b12 = b + h, *b21 = b + h * ldb, *b22 = b + h * ldb + h;
+        double *c11 = c, *c12 = c + h, *c21 = c + h * ldc, *c22 = c + h * ldc + h;
+        double *x = workspace;
+        double *y = workspace + h * h;
+        double *next = workspace + 2 * h * h;
+
+        subtract(h, a11, lda, a21, lda, x, h);                      // S3 = A11 - A21
+        subtract(h, b22, ldb, b12, ldb, y, h);                      // T3 = B22 - B12
+        multiply(h, depth - 1, x, h, y, h, c21, ldc, next);         // P7 = S3 T3
+        add(h, a21, lda, a22, lda, x, h);                           // S1 = A21 + A22
+        subtract(h, b12, ldb, b11, ldb, y, h);                      // T1 = B12 - B11
+        multiply(h, depth - 1, x, h, y, h, c22, ldc, next);         // P5 = S1 T1
+        subtract(h, x, h, a11, lda, x, h);                          // S2 = S1 - A11
+        subtract(h, b22, ldb, y, h, y, h);                          // T2 = B22 - T1
+        multiply(h, depth - 1, x, h, y, h, c12, ldc, next);         // P6 = S2 T2
+        subtract(h, a12, lda, x, h, x, h);                          // S4 = A12 - S2
+        multiply(h, depth - 1, x, h, b22, ldb, c11, ldc, next);     // P3 = S4 B22
+        multiply(h, depth - 1, a11, lda, b11, ldb, x, h, next);     // P1 = A11 B11
+        add(h, x, h, c12, ldc, c12, ldc);                           // U2 = P1 + P6
+        add(h, c12, ldc, c21, ldc, c21, ldc);                       // U3 = U2 + P7
+        add(h, c12, ldc, c22, ldc, c12, ldc);                       // U4 = U2 + P5
+        add(h, c21, ldc, c22, ldc, c22, ldc);                       // U7 = U3 + P5 = C22
+        add(h, c12, ldc, c11, ldc, c12, ldc);                       // U5 = U4 + P3 = C12
+        subtract(h, y, h, b21, ldb, y, h);                          // T4 = T2 - B21
+        multiply(h, depth - 1, a22, lda, y, h, c11, ldc, next);     // P4 = A22 T4
+        subtract(h, c21, ldc, c11, ldc, c21, ldc);                  // U6 = U3 - P4 = C21
+        multiply(h, depth - 1, a12, lda, b21, ldb, c11, ldc, next); // P2 = A12 B21
+        add(h, x, h, c11, ldc, c11, ldc);                           // U1 = P1 + P2 = C11
+    }
+
+    Buffer pad(const Matrix &matrix, size_t padded) {
+        size_t n = matrix.getRowsNum();
+        Buffer buffer(padded * padded, 0.0, scratch_resource());
+        for (size_t i = 0; i < n; i++) {
+            std::copy(matrix[i], matrix[i] + n, buffer.data() + i * padded);
+        }
+        return buffer;
+    }
+
+}  // namespace
+
+Matrix task::strassenMultiply(const Matrix &a, const Matrix &b, size_t crossover) {
+    size_t n = a.getRowsNum();
+    if (a.getColumnsNum() != b.getRowsNum()) {
+        throw SizeMismatchException();
+    }
+    if (n != a.getColumnsNum() || n != b.getColumnsNum() || n <= crossover) {
+        return a * b;
+    }
+
+    Plan plan = make_plan(n, crossover);
+
+    size_t workspace_size = 0;
+    for (size_t level = 1, size = plan.padded / 2; level <= plan.depth; level++, size /= 2) {
+        workspace_size += 2 * size * size;
+    }
+
+    Buffer padded_a = pad(a, plan.padded);
+    Buffer padded_b = pad(b, plan.padded);
+    Buffer padded_c(plan.padded * plan.padded, scratch_resource());
+    Buffer workspace(workspace_size, scratch_resource());
+
+    multiply(plan.padded, plan.depth, padded_a.data(), plan.padded, padded_b.data(), plan.padded,
+             padded_c.data(), plan.padded, workspace.data());
+
+    Matrix result(n, n);
+    for (size_t i = 0; i < n; i++) {
+        std::copy(padded_c.data() + i * plan.padded, padded_c.data() + i * plan.padded + n, result[i]);
+    }
+
+    return result;
+}
+
+double task::strassenErrorBound(size_t n, size_t crossover) {
+    const double u = std::numeric_limits<double>::epsilon() / 2;
+
+    if (n <= crossover) {
+        double size = static_cast<double>(n);
+        return size * size * u;
+    }
+
+    Plan plan = make_plan(n, crossover);
+    double n0 = static_cast<double>(plan.leaf);
+    double size = static_cast<double>(plan.padded);
+
+    return (std::pow(18.0, plan.depth) * (n0 * n0 + 6 * n0) - 6 * size) * u;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include "matrix.h"
+
+
+namespace task {
+
+    const size_t STRASSEN_CROSSOVER = 512;
+
+    // Opt-in Strassen-Winograd product of square matrices (7 products, 15 additions per level).
+    // The matrices are zero-padded so that halving d times lands on a leaf of at most
+    // `crossover` rows, which go through the blocked GEMM kernel. Workspace for all levels is
+    // allocated once up front. Non-square operands, or n <= crossover, use operator*.
+    Matrix strassenMultiply(const Matrix &a, const Matrix &b, size_t crossover = STRASSEN_CROSSOVER);
+
+    // Accuracy: unlike the classic product's componentwise bound |C - C'| <= n u |A||B|, the
+    // Winograd variant only satisfies a normwise one (Higham, "Accuracy and Stability of
+    // Numerical Algorithms", 2nd ed., sec. 23.2.2):
+    //     max|C - C'| <= [(n / n0)^log2(18) (n0^2 + 6 n0) - 6 n] u max|A| max|B|,
+    // where n0 is the leaf size and u the unit roundoff. Returns the bracket times u for the
+    // padded size and leaf that strassenMultiply(n x n, n x n, crossover) uses; with no
+    // recursion that is the classic bound in the same norm, n^2 u.
+    double strassenErrorBound(size_t n, size_t crossover = STRASSEN_CROSSOVER);
+
+}  // namespace task
@@ -0,0 +1,162 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+using namespace task;
+
+namespace {
+
+    std::mutex instance_mutex;
+    std::shared_ptr<ThreadPool> pool;
+    size_t requested_threads = 0;
+
+    thread_local bool inside_pool = false;
+
+    size_t resolve_threads(size_t threads) {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        return threads == 0 ? 1 : threads;
+    }
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threads)
+        : body(nullptr), count(0), next(0), busy(0), generation(0), stopping(false) {
+    threads = resolve_threads(threads);
+    for (size_t i = 1; i < threads; i++) {
+        this->workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->start.notify_all();
+
+    for (std::thread &worker : this->workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return this->workers.size() + 1;
+}
+
+void ThreadPool::run_tasks() {
+    for (size_t i = this->next++; i < this->count; i = this->next++) {
+        try {
+            (*this->body)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (!this->error) {
+                this->error = std::current_exception();
+            }
+            this->next = this->count;
+        }
+    }
+}
+
+void ThreadPool::work() {
+    inside_pool = true;
+    size_t seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->start.wait(lock, [&] { return this->stopping || this->generation != seen; });
+            if (this->stopping) {
+                return;
+            }
+            seen = this->generation;
+        }
+
+        run_tasks();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (--this->busy == 0) {
+            this->finish.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)> &body) {
+    if (count == 0) {
+        return;
+    }
+    if (this->workers.empty() || count == 1 || inside_pool) {
+        for (size_t i = 0; i < count; i++) {
+            body(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit_lock(this->submit_mutex);
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->body = &body;
+        this->count = count;
+        this->next = 0;
+        this->busy = this->workers.size();
+        this->generation++;
+    }
+    this->start.notify_all();
+
+    inside_pool = true;
+    run_tasks();
+    inside_pool = false;
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->finish.wait(lock, [&] { return this->busy == 0; });
+    this->body = nullptr;
+
+    std::exception_ptr error = this->error;
+    this->error = nullptr;
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::instance() {
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    if (!pool) {
+        pool = std::make_shared<ThreadPool>(requested_threads);
+    }
+    return pool;
+}
+
+void task::set_num_threads(size_t threads) {
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    if (pool && pool->size() == resolve_threads(threads)) {
+        requested_threads = threads;
+        return;
+    }
+    requested_threads = threads;
+    // Callers still running on the old pool hold their own reference; the last one joins it.
+    pool.reset();
+}
+
+size_t task::get_num_threads() {
+    return ThreadPool::instance()->size();
+}
+
+void task::parallel_ranges(size_t count, size_t length, size_t work,
+                           const std::function<void(size_t, size_t, size_t)> &body) {
+    length = std::max<size_t>(length, 1);
+    size_t ranges = (count + length - 1) / length;
+    auto run = [&](size_t range) {
+        body(range, range * length, std::min(count, (range + 1) * length));
+    };
+
+    if (ranges > 1 && work >= PARALLEL_THRESHOLD) {
+        std::shared_ptr<ThreadPool> pool = ThreadPool::instance();
+        if (pool->size() > 1) {
+            pool->parallel_for(ranges, run);
+            return;
+        }
+    }
+    for (size_t range = 0; range < ranges; range++) {
+        run(range);
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+
+namespace task {
+
+    class ThreadPool {
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::mutex submit_mutex;
+        std::condition_variable start;
+        std::condition_variable finish;
+
+        const std::function<void(size_t)> *body;
+        size_t count;
+        std::atomic<size_t> next;
+        size_t busy;
+        size_t generation;
+        bool stopping;
+        std::exception_ptr error;
+
+        void work();
+
+        void run_tasks();
+
+    public:
+
+        explicit ThreadPool(size_t threads);
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        ~ThreadPool();
+
+        size_t size() const;
+
+        // Calls body(0) ... body(count - 1) on the pool and the calling thread, returns when all are done.
+        // If a call throws, the remaining indices are skipped and the first exception is rethrown here.
+        void parallel_for(size_t count, const std::function<void(size_t)> &body);
+
+        // The shared pool. Holding the pointer keeps it alive while set_num_threads() replaces it.
+        static std::shared_ptr<ThreadPool> instance();
+    };
+
+    // Below this many multiply-adds (or elements, for reductions) the pool's hand-off costs more
+    // than it saves, so parallel_ranges() stays on the calling thread.
+    const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+    // Calls body(range, begin, end) for consecutive ranges of `length` indices covering [0, count),
+    // on the pool when there are several and `work` reaches PARALLEL_THRESHOLD. The ranges depend
+    // only on the arguments and each writes its own outputs, so results are the same for any
+    // number of threads.
+    void parallel_ranges(size_t count, size_t length, size_t work,
+                         const std::function<void(size_t, size_t, size_t)> &body);
+
+    // Number of threads used by the parallel kernels, including the caller. 0 means hardware concurrency.
+    void set_num_threads(size_t threads);
+
+    size_t get_num_threads();
+
+}  // namespace task
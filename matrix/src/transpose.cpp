@@ -0,0 +1,89 @@
+#include "transpose.h"
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using namespace task;
+
+namespace {
+
+    // Below this edge a block of source and destination fits in L1 together.
+    const size_t BLOCK = 32;
+
+    void transpose_block(size_t rows, size_t cols, const double *src, size_t lds, double *dst, size_t ldd) {
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                dst[j * ldd + i] = src[i * lds + j];
+            }
+        }
+    }
+
+    // Swaps block (i, j) with the transpose of block (j, i) without a buffer.
+    void swap_transposed(size_t rows, size_t cols, double *upper, double *lower, size_t lda) {
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                std::swap(upper[i * lda + j], lower[j * lda + i]);
+            }
+        }
+    }
+
+}  // namespace
+
+// Cache-oblivious: split the longer side in half until the block is small enough.
+void detail::transpose(size_t rows, size_t cols, const double *src, size_t lds, double *dst, size_t ldd) {
+    if (rows <= BLOCK && cols <= BLOCK) {
+        transpose_block(rows, cols, src, lds, dst, ldd);
+    } else if (rows >= cols) {
+        size_t half = rows / 2;
+        transpose(half, cols, src, lds, dst, ldd);
+        transpose(rows - half, cols, src + half * lds, lds, dst + half, ldd);
+    } else {
+        size_t half = cols / 2;
+        transpose(rows, half, src, lds, dst, ldd);
+        transpose(rows, cols - half, src + half, lds, dst + half * ldd, ldd);
+    }
+}
+
+void detail::transpose_square(size_t n, double *a, size_t lda) {
+    for (size_t ib = 0; ib < n; ib += BLOCK) {
+        size_t rows = std::min(BLOCK, n - ib);
+
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = i + 1; j < rows; j++) {
+                std::swap(a[(ib + i) * lda + ib + j], a[(ib + j) * lda + ib + i]);
+            }
+        }
+
+        for (size_t jb = ib + BLOCK; jb < n; jb += BLOCK) {
+            size_t cols = std::min(BLOCK, n - jb);
+            swap_transposed(rows, cols, a + ib * lda + jb, a + jb * lda + ib, lda);
+        }
+    }
+}
+
+// Element k of the rows x cols layout moves to (k * rows) mod (size - 1) in the cols x rows one.
+// Only a bitmap of visited positions is kept, so extra memory is size / 8 bytes.
+void detail::transpose_dense(size_t rows, size_t cols, double *a) {
+    size_t size = rows * cols;
+    if (rows <= 1 || cols <= 1) {
+        return;
+    }
+
+    std::vector<bool> visited(size, false);
+    size_t last = size - 1;
+
+    for (size_t start = 1; start < last; start++) {
+        if (visited[start]) {
+            continue;
+        }
+
+        size_t position = start;
+        double carried = a[start];
+        do {
+            size_t next = position * rows % last;
+            std::swap(a[next], carried);
+            visited[position] = true;
+            position = next;
+        } while (position != start);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace task {
+
+    namespace detail {
+
+        // dst (cols x rows, leading dimension ldd) = transpose of src (rows x cols, leading dimension lds).
+        void transpose(size_t rows, size_t cols, const double *src, size_t lds, double *dst, size_t ldd);
+
+        // In-place transpose of an n x n block with leading dimension lda.
+        void transpose_square(size_t n, double *a, size_t lda);
+
+        // In-place transpose of a dense rows x cols buffer into cols x rows, following permutation cycles.
+        void transpose_dense(size_t rows, size_t cols, double *a);
+
+    }  // namespace detail
+
+}  // namespace task
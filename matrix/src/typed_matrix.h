@@ -0,0 +1,160 @@
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+#include "matrix.h"
+
+
+namespace task {
+
+    namespace detail {
+
+        template<class T>
+        struct is_complex : std::false_type {
+        };
+
+        template<class T>
+        struct is_complex<std::complex<T>> : std::true_type {
+        };
+
+        template<class T>
+        struct complex_value {
+            using type = T;
+        };
+
+        template<class T>
+        struct complex_value<std::complex<T>> {
+            using type = T;
+        };
+
+        template<class A, class B>
+        struct promote {
+            using value = std::common_type_t<typename complex_value<A>::type, typename complex_value<B>::type>;
+            using type = std::conditional_t<is_complex<A>::value || is_complex<B>::value, std::complex<value>, value>;
+        };
+
+    }  // namespace detail
+
+    // Thrown by the exact integer det() when the determinant does not fit the element type.
+    class IntegerOverflowException : public std::exception {
+    };
+
+
+    // Element type both operands should be cast<>() to before mixing them, e.g.
+    // a.cast<promote_t<float, int32_t>>() + b.cast<promote_t<float, int32_t>>().
+    template<class A, class B>
+    using promote_t = typename detail::promote<A, B>::type;
+
+    // Dense row-major matrix over float, double, integer or std::complex elements.
+    // Operations only combine matrices of one element type; mixing types needs an explicit cast<>().
+    // Equality is EPS-based for floating-point and complex elements and exact for integers;
+    // det() is exact (fraction-free Bareiss elimination) for integers and throws
+    // IntegerOverflowException when the result does not fit T.
+    template<class T>
+    class TypedMatrix {
+        static_assert(std::is_arithmetic<T>::value || detail::is_complex<T>::value,
+                      "TypedMatrix elements must be arithmetic or std::complex");
+
+        T *data;
+        size_t rows;
+        size_t columns;
+
+        void check_bounds(size_t, size_t) const;
+
+        void check_size(size_t, size_t) const;
+
+    public:
+
+        using value_type = T;
+
+        TypedMatrix();
+
+        TypedMatrix(size_t rows, size_t cols);
+
+        explicit TypedMatrix(const Matrix &matrix);
+
+        TypedMatrix(const TypedMatrix &copy);
+
+        TypedMatrix(TypedMatrix &&other) noexcept;
+
+        TypedMatrix &operator=(const TypedMatrix &a);
+
+        TypedMatrix &operator=(TypedMatrix &&other) noexcept;
+
+        ~TypedMatrix();
+
+        template<class U>
+        TypedMatrix<U> cast() const;
+
+        Matrix toMatrix() const;
+
+        T &get(size_t row, size_t col);
+
+        const T &get(size_t row, size_t col) const;
+
+        void set(size_t row, size_t col, const T &value);
+
+        T *operator[](size_t row);
+
+        T const *operator[](size_t row) const;
+
+        TypedMatrix &operator+=(const TypedMatrix &a);
+
+        TypedMatrix &operator-=(const TypedMatrix &a);
+
+        TypedMatrix &operator*=(const TypedMatrix &a);
+
+        TypedMatrix &operator*=(const T &number);
+
+        TypedMatrix operator+(const TypedMatrix &a) const;
+
+        TypedMatrix operator-(const TypedMatrix &a) const;
+
+        TypedMatrix operator*(const TypedMatrix &a) const;
+
+        TypedMatrix operator*(const T &a) const;
+
+        TypedMatrix operator-() const;
+
+        TypedMatrix operator+() const;
+
+        T det() const;
+
+        void transpose();
+
+        TypedMatrix transposed() const;
+
+        T trace() const;
+
+        bool operator==(const TypedMatrix &a) const;
+
+        bool operator!=(const TypedMatrix &a) const;
+
+        size_t getRowsNum() const;
+
+        size_t getColumnsNum() const;
+    };
+
+    template<class T>
+    TypedMatrix<T> operator*(const T &a, const TypedMatrix<T> &b);
+
+    template<class T>
+    std::ostream &operator<<(std::ostream &output, const TypedMatrix<T> &matrix);
+
+    using MatrixF = TypedMatrix<float>;
+
+    using MatrixD = TypedMatrix<double>;
+
+    using MatrixI32 = TypedMatrix<int32_t>;
+
+    using MatrixI64 = TypedMatrix<int64_t>;
+
+    using MatrixC = TypedMatrix<std::complex<double>>;
+
+}  // namespace task
+
+
+#include "typed_matrix.tpp"
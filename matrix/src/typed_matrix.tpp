@@ -0,0 +1,449 @@
+#include "typed_matrix.h"
+#include <cmath>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "gemm.h"
+
+namespace task {
+
+    namespace detail {
+
+        template<class T>
+        struct is_simd_float : std::integral_constant<bool,
+                std::is_same<T, double>::value || std::is_same<T, float>::value> {
+        };
+
+        // float and double go through the dispatched SIMD kernels; integer and complex
+        // loops are left to the auto-vectorizer over the contiguous buffer.
+        template<class T>
+        void typed_add(const T *a, const T *b, T *out, size_t n) {
+            if constexpr (is_simd_float<T>::value) {
+                add(a, b, out, n);
+            } else {
+                for (size_t i = 0; i < n; i++) {
+                    out[i] = a[i] + b[i];
+                }
+            }
+        }
+
+        template<class T>
+        void typed_subtract(const T *a, const T *b, T *out, size_t n) {
+            if constexpr (is_simd_float<T>::value) {
+                subtract(a, b, out, n);
+            } else {
+                for (size_t i = 0; i < n; i++) {
+                    out[i] = a[i] - b[i];
+                }
+            }
+        }
+
+        template<class T>
+        void typed_scale(const T *a, T factor, T *out, size_t n) {
+            if constexpr (is_simd_float<T>::value) {
+                scale(a, factor, out, n);
+            } else {
+                for (size_t i = 0; i < n; i++) {
+                    out[i] = factor * a[i];
+                }
+            }
+        }
+
+        // c (m x n) = a (m x k) * b (k x n), all dense. double reuses the packed GEMM;
+        // other types stream rows of b in i-p-j order, k-blocked to keep the b panel in cache.
+        template<class T>
+        void typed_gemm(size_t m, size_t n, size_t k, const T *a, const T *b, T *c) {
+            if constexpr (std::is_same<T, double>::value) {
+                gemm(m, n, k, 1.0, a, k, b, n, 0.0, c, n);
+            } else {
+                const size_t block = 256;
+                std::fill(c, c + m * n, T());
+
+                for (size_t pc = 0; pc < k; pc += block) {
+                    size_t kc = std::min(block, k - pc);
+                    for (size_t i = 0; i < m; i++) {
+                        T *c_row = c + i * n;
+                        for (size_t p = pc; p < pc + kc; p++) {
+                            T factor = a[i * k + p];
+                            const T *b_row = b + p * n;
+                            for (size_t j = 0; j < n; j++) {
+                                c_row[j] += factor * b_row[j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        template<class T>
+        bool typed_equal(const T &a, const T &b) {
+            if constexpr (std::is_integral<T>::value) {
+                return a == b;
+            } else {
+                return std::abs(a - b) <= EPS;
+            }
+        }
+
+    }  // namespace detail
+
+    template<class T>
+    void TypedMatrix<T>::check_bounds(size_t rows, size_t columns) const {
+        if (rows >= this->rows || columns >= this->columns) {
+            throw OutOfBoundsException();
+        }
+    }
+
+    template<class T>
+    void TypedMatrix<T>::check_size(size_t rows, size_t columns) const {
+        if (this->rows != rows || this->columns != columns) {
+            throw SizeMismatchException();
+        }
+    }
+
+    template<class T>
+    TypedMatrix<T>::TypedMatrix() : TypedMatrix(1, 1) {
+    }
+
+    template<class T>
+    TypedMatrix<T>::TypedMatrix(size_t rows, size_t cols)
+            : data(new T[rows * cols]()), rows(rows), columns(cols) {
+        for (size_t i = 0; i < std::min(rows, cols); i++) {
+            this->data[i * cols + i] = T(1);
+        }
+    }
+
+    template<class T>
+    TypedMatrix<T>::TypedMatrix(const Matrix &matrix)
+            : data(new T[matrix.getRowsNum() * matrix.getColumnsNum()]),
+              rows(matrix.getRowsNum()), columns(matrix.getColumnsNum()) {
+        for (size_t i = 0; i < this->rows; i++) {
+            const double *row = matrix[i];
+            for (size_t j = 0; j < this->columns; j++) {
+                this->data[i * this->columns + j] = static_cast<T>(row[j]);
+            }
+        }
+    }
+
+    template<class T>
+    TypedMatrix<T>::TypedMatrix(const TypedMatrix &copy)
+            : data(new T[copy.rows * copy.columns]), rows(copy.rows), columns(copy.columns) {
+        std::copy(copy.data, copy.data + this->rows * this->columns, this->data);
+    }
+
+    template<class T>
+    TypedMatrix<T>::TypedMatrix(TypedMatrix &&other) noexcept
+            : data(other.data), rows(other.rows), columns(other.columns) {
+        other.data = nullptr;
+        other.rows = 0;
+        other.columns = 0;
+    }
+
+    template<class T>
+    TypedMatrix<T> &TypedMatrix<T>::operator=(const TypedMatrix &a) {
+        if (this != &a) {
+            *this = TypedMatrix(a);
+        }
+        return *this;
+    }
+
+    template<class T>
+    TypedMatrix<T> &TypedMatrix<T>::operator=(TypedMatrix &&other) noexcept {
+        std::swap(this->data, other.data);
+        std::swap(this->rows, other.rows);
+        std::swap(this->columns, other.columns);
+        return *this;
+    }
+
+    template<class T>
+    TypedMatrix<T>::~TypedMatrix() {
+        delete[] this->data;
+    }
+
+    template<class T>
+    template<class U>
+    TypedMatrix<U> TypedMatrix<T>::cast() const {
+        TypedMatrix<U> new_matrix(this->rows, this->columns);
+        for (size_t i = 0; i < this->rows; i++) {
+            U *row = new_matrix[i];
+            for (size_t j = 0; j < this->columns; j++) {
+                row[j] = static_cast<U>(this->data[i * this->columns + j]);
+            }
+        }
+        return new_matrix;
+    }
+
+    template<class T>
+    Matrix TypedMatrix<T>::toMatrix() const {
+        static_assert(!detail::is_complex<T>::value, "complex matrices have no real Matrix counterpart");
+
+        Matrix new_matrix(this->rows, this->columns);
+        for (size_t i = 0; i < this->rows; i++) {
+            double *row = new_matrix[i];
+            for (size_t j = 0; j < this->columns; j++) {
+                row[j] = static_cast<double>(this->data[i * this->columns + j]);
+            }
+        }
+        return new_matrix;
+    }
+
+    template<class T>
+    T &TypedMatrix<T>::get(size_t row, size_t col) {
+        check_bounds(row, col);
+        return this->data[row * this->columns + col];
+    }
+
+    template<class T>
+    const T &TypedMatrix<T>::get(size_t row, size_t col) const {
+        check_bounds(row, col);
+        return this->data[row * this->columns + col];
+    }
+
+    template<class T>
+    void TypedMatrix<T>::set(size_t row, size_t col, const T &value) {
+        get(row, col) = value;
+    }
+
+    template<class T>
+    T *TypedMatrix<T>::operator[](size_t row) {
+        check_bounds(row, 0);
+        return this->data + row * this->columns;
+    }
+
+    template<class T>
+    T const *TypedMatrix<T>::operator[](size_t row) const {
+        check_bounds(row, 0);
+        return this->data + row * this->columns;
+    }
+
+    template<class T>
+    TypedMatrix<T> &TypedMatrix<T>::operator+=(const TypedMatrix &a) {
+        check_size(a.rows, a.columns);
+        detail::typed_add(this->data, a.data, this->data, this->rows * this->columns);
+        return *this;
+    }
+
+    template<class T>
+    TypedMatrix<T> &TypedMatrix<T>::operator-=(const TypedMatrix &a) {
+        check_size(a.rows, a.columns);
+        detail::typed_subtract(this->data, a.data, this->data, this->rows * this->columns);
+        return *this;
+    }
+
+    template<class T>
+    TypedMatrix<T> &TypedMatrix<T>::operator*=(const TypedMatrix &a) {
+        *this = *this * a;
+        return *this;
+    }
+
+    template<class T>
+    TypedMatrix<T> &TypedMatrix<T>::operator*=(const T &number) {
+        detail::typed_scale(this->data, number, this->data, this->rows * this->columns);
+        return *this;
+    }
+
+    template<class T>
+    TypedMatrix<T> TypedMatrix<T>::operator+(const TypedMatrix &a) const {
+        TypedMatrix new_matrix(*this);
+        new_matrix += a;
+        return new_matrix;
+    }
+
+    template<class T>
+    TypedMatrix<T> TypedMatrix<T>::operator-(const TypedMatrix &a) const {
+        TypedMatrix new_matrix(*this);
+        new_matrix -= a;
+        return new_matrix;
+    }
+
+    template<class T>
+    TypedMatrix<T> TypedMatrix<T>::operator*(const TypedMatrix &a) const {
+        if (this->columns != a.rows) {
+            throw SizeMismatchException();
+        }
+
+        TypedMatrix new_matrix(this->rows, a.columns);
+        detail::typed_gemm(this->rows, a.columns, this->columns, this->data, a.data, new_matrix.data);
+        return new_matrix;
+    }
+
+    template<class T>
+    TypedMatrix<T> TypedMatrix<T>::operator*(const T &a) const {
+        TypedMatrix new_matrix(*this);
+        new_matrix *= a;
+        return new_matrix;
+    }
+
+    template<class T>
+    TypedMatrix<T> TypedMatrix<T>::operator-() const {
+        return *this * T(-1);
+    }
+
+    template<class T>
+    TypedMatrix<T> TypedMatrix<T>::operator+() const {
+        return *this;
+    }
+
+    template<class T>
+    T TypedMatrix<T>::det() const {
+        if (this->rows != this->columns) {
+            throw SizeMismatchException();
+        }
+
+        size_t n = this->rows;
+        if (n == 0) {
+            return T(1);
+        }
+        bool negative = false;
+
+        if constexpr (std::is_integral<T>::value) {
+            // Bareiss: every intermediate is itself a minor, so the divisions are exact. Minors
+            // outgrow T long before the determinant does, so they are kept in 128 bits and a
+            // product that overflows even those, or a result T cannot hold, is reported.
+            std::vector<__int128> a(this->data, this->data + n * n);
+            __int128 previous = 1;
+            for (size_t k = 0; k + 1 < n; k++) {
+                if (a[k * n + k] == 0) {
+                    size_t swap_row = k + 1;
+                    while (swap_row < n && a[swap_row * n + k] == 0) {
+                        swap_row++;
+                    }
+                    if (swap_row == n) {
+                        return T(0);
+                    }
+                    std::swap_ranges(a.begin() + k * n, a.begin() + k * n + n, a.begin() + swap_row * n);
+                    negative = !negative;
+                }
+
+                for (size_t i = k + 1; i < n; i++) {
+                    for (size_t j = k + 1; j < n; j++) {
+                        __int128 kept, removed;
+                        if (__builtin_mul_overflow(a[i * n + j], a[k * n + k], &kept) ||
+                            __builtin_mul_overflow(a[i * n + k], a[k * n + j], &removed) ||
+                            __builtin_sub_overflow(kept, removed, &kept)) {
+                            throw IntegerOverflowException();
+                        }
+                        a[i * n + j] = kept / previous;
+                    }
+                }
+                previous = a[k * n + k];
+            }
+
+            __int128 det = negative ? -a[n * n - 1] : a[n * n - 1];
+            if (det < std::numeric_limits<T>::min() || det > std::numeric_limits<T>::max()) {
+                throw IntegerOverflowException();
+            }
+            return T(det);
+        } else {
+            TypedMatrix lu(*this);
+            T *a = lu.data;
+            T det = T(1);
+            for (size_t k = 0; k < n; k++) {
+                size_t pivot = k;
+                for (size_t i = k + 1; i < n; i++) {
+                    if (std::abs(a[i * n + k]) > std::abs(a[pivot * n + k])) {
+                        pivot = i;
+                    }
+                }
+                if (a[pivot * n + k] == T(0)) {
+                    return T(0);
+                }
+                if (pivot != k) {
+                    std::swap_ranges(a + k * n + k, a + k * n + n, a + pivot * n + k);
+                    negative = !negative;
+                }
+
+                det *= a[k * n + k];
+                for (size_t i = k + 1; i < n; i++) {
+                    T factor = a[i * n + k] / a[k * n + k];
+                    for (size_t j = k + 1; j < n; j++) {
+                        a[i * n + j] -= factor * a[k * n + j];
+                    }
+                }
+            }
+            return negative ? -det : det;
+        }
+    }
+
+    template<class T>
+    void TypedMatrix<T>::transpose() {
+        *this = transposed();
+    }
+
+    template<class T>
+    TypedMatrix<T> TypedMatrix<T>::transposed() const {
+        const size_t block = 32;
+        TypedMatrix new_matrix(this->columns, this->rows);
+
+        for (size_t ib = 0; ib < this->rows; ib += block) {
+            for (size_t jb = 0; jb < this->columns; jb += block) {
+                for (size_t i = ib; i < std::min(ib + block, this->rows); i++) {
+                    for (size_t j = jb; j < std::min(jb + block, this->columns); j++) {
+                        new_matrix.data[j * this->rows + i] = this->data[i * this->columns + j];
+                    }
+                }
+            }
+        }
+
+        return new_matrix;
+    }
+
+    template<class T>
+    T TypedMatrix<T>::trace() const {
+        if (this->rows != this->columns) {
+            throw SizeMismatchException();
+        }
+
+        T result = T();
+        for (size_t i = 0; i < this->rows; i++) {
+            result += this->data[i * this->columns + i];
+        }
+        return result;
+    }
+
+    template<class T>
+    bool TypedMatrix<T>::operator==(const TypedMatrix &a) const {
+        if (this->rows != a.rows || this->columns != a.columns) {
+            return false;
+        }
+
+        for (size_t i = 0; i < this->rows * this->columns; i++) {
+            if (!detail::typed_equal(this->data[i], a.data[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class T>
+    bool TypedMatrix<T>::operator!=(const TypedMatrix &a) const {
+        return !(*this == a);
+    }
+
+    template<class T>
+    size_t TypedMatrix<T>::getRowsNum() const {
+        return this->rows;
+    }
+
+    template<class T>
+    size_t TypedMatrix<T>::getColumnsNum() const {
+        return this->columns;
+    }
+
+    template<class T>
+    TypedMatrix<T> operator*(const T &a, const TypedMatrix<T> &b) {
+        return b * a;
+    }
+
+    template<class T>
+    std::ostream &operator<<(std::ostream &output, const TypedMatrix<T> &matrix) {
+        for (size_t i = 0; i < matrix.getRowsNum(); i++) {
+            for (size_t j = 0; j < matrix.getColumnsNum(); j++) {
+                output << matrix[i][j] << ' ';
+            }
+            output << '\n';
+        }
+        return output;
+    }
+
+}  // namespace task
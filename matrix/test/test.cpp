@@ -1,10 +1,28 @@
 #include <iostream>
 #include <string>
+#include <vector>
 #include <random>
 #include <algorithm>
+#include <utility>
 #include <sstream>
+#include <fstream>
+#include <cstdio>
 #include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include <new>
 #include "src/matrix.h"
+#include "src/typed_matrix.h"
+#include "src/matrix_io.h"
+#include "src/strassen.h"
+#include "src/sparse_matrix.h"
+#include "src/factorization.h"
+#include "src/thread_pool.h"
+#include "src/matrix_batch.h"
+#include "src/fixed_matrix.h"
 
 
 using task::Matrix;
@@ -33,6 +51,30 @@ double RandomDouble() {
     return dist(rand);
 }
 
+// Forwards to new / delete and counts the allocations made through it.
+class CountingResource : public std::pmr::memory_resource {
+    size_t count = 0;
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        count++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+
+    size_t allocations() const {
+        return count;
+    }
+};
+
 Matrix RandomMatrix(size_t rows, size_t cols) {
     Matrix temp(rows, cols);
     for (size_t row = 0; row < rows; ++row) {
@@ -208,6 +250,1032 @@ int main(int argc, char** argv) {
     }
 
 
+    {
+        const char *path = "matrix_test_corrupt.bin";
+
+        task::saveBinary(Matrix(3, 0), path);
+        auto empty = task::loadBinary(path);
+        ASSERT_TRUE_MSG(empty.getRowsNum() == 3 && empty.getColumnsNum() == 0, "Binary save / load of 3 x 0")
+
+        task::saveBinary(RandomMatrix(2, 2), path);
+        {
+            // Claim 200000 x 200000 in a header followed by only four values.
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            uint64_t dimension = 200000;
+            file.seekp(16);
+            file.write(reinterpret_cast<const char *>(&dimension), sizeof(dimension));
+            file.write(reinterpret_cast<const char *>(&dimension), sizeof(dimension));
+        }
+        ASSERT_EXCEPTION_MSG(task::loadBinary(path), task::MatrixFormatException, "Binary load of a corrupt header")
+        ASSERT_EXCEPTION_MSG(task::MappedMatrix(path), task::MatrixFormatException, "Mapping a corrupt header")
+
+        // A header alone, claiming (2^61 - 1) x 1: the byte total would wrap to less than 64.
+        task::saveBinary(Matrix(1, 0), path);
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            uint64_t dimensions[2] = {(uint64_t(1) << 61) - 1, 1};
+            file.seekp(16);
+            file.write(reinterpret_cast<const char *>(dimensions), sizeof(dimensions));
+        }
+        ASSERT_EXCEPTION_MSG(task::loadBinary(path), task::MatrixFormatException, "Binary load of a wrapping header")
+        ASSERT_EXCEPTION_MSG(task::MappedMatrix(path), task::MatrixFormatException, "Mapping a wrapping header")
+
+        std::remove(path);
+    }
+
+
+    {
+        auto mat1 = RandomMatrix(3, 4);
+        mat1[0][0] = 1e300;
+        Matrix mat2;
+
+        std::stringstream stream;
+        stream << std::fixed;
+        stream.precision(10000);
+        stream << "3 4\n" << mat1;
+        stream >> mat2;
+
+        ASSERT_TRUE_MSG(stream && mat1 == mat2, "Stream output with a large precision")
+    }
+
+
+    REPEAT(20)
+    {
+        size_t n = RandomUInt(0, 14);
+        task::MatrixI32 mat(n, n);
+        Matrix reference(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                mat[i][j] = static_cast<int32_t>(RandomUInt(0, 4)) - 2;
+                reference[i][j] = mat[i][j];
+            }
+        }
+
+        double expected = std::round(reference.det());
+        if (std::fabs(expected) <= INT32_MAX) {
+            ASSERT_TRUE_MSG(mat.det() == expected, "Exact integer determinant")
+        } else {
+            ASSERT_EXCEPTION_MSG(mat.det(), task::IntegerOverflowException, "Integer determinant overflow")
+        }
+        ASSERT_TRUE_MSG(task::MatrixI64(mat.cast<int64_t>()).det() == expected, "Exact integer determinant")
+    }
+
+
+    {
+        auto mat1 = RandomMatrix(30, 30);
+        auto mat2 = RandomMatrix(30, 30);
+        auto expected = mat1 * mat2;
+
+        Matrix res(30, 30);
+        Matrix small(2, 2);
+        {
+            std::pmr::monotonic_buffer_resource arena;
+            task::MatrixResourceScope scope(&arena);
+            res = mat1 * mat2;
+            small = Matrix(2, 2) * 3.;
+        }
+
+        ASSERT_TRUE_MSG(res.getResource() == nullptr && small.getResource() == nullptr,
+                        "Move assignment keeps the destination's resource")
+        ASSERT_TRUE_MSG(res == expected, "Move assignment across resources")
+        ASSERT_TRUE_MSG(small[0][0] == 3. && small[0][1] == 0., "Move assignment across resources")
+    }
+
+
+    {
+        auto mat1 = RandomMatrix(20, 30);
+        const Matrix original = mat1;
+
+        auto mat2 = mat1;
+        const Matrix &shared = mat2;
+        ASSERT_TRUE_MSG(shared[0] == original[0], "Copies share one buffer")
+
+        mat2[3][4] += 1.;
+        ASSERT_TRUE_MSG(shared[0] != original[0], "Write through [] detaches")
+        ASSERT_TRUE_MSG(mat1[3][4] == original[3][4] && mat2[3][4] == original[3][4] + 1., "Write through [] detaches")
+
+        auto mat3 = mat1;
+        mat3 += RandomMatrix(20, 30);
+        ASSERT_TRUE_MSG(mat1 == original && mat3 != original, "Operator += detaches")
+
+        auto mat4 = mat1;
+        mat4.transpose();
+        ASSERT_TRUE_MSG(mat1 == original && mat4 == original.transposed(), "transpose() detaches")
+
+        auto mat5 = mat1;
+        mat5.set(0, 0, original[0][0] + 1.);
+        ASSERT_TRUE_MSG(mat1 == original && mat5[0][0] == original[0][0] + 1., "set() detaches")
+    }
+
+
+    {
+        auto small = RandomMatrix(3, 4);
+        const Matrix original = small;
+        ASSERT_TRUE_MSG(small.capacity() == 16 && original.capacity() == 16, "Small matrices are stored inline")
+
+        Matrix moved = std::move(small);
+        ASSERT_TRUE_MSG(moved == original && moved.capacity() == 16, "Moving an inline matrix")
+
+        moved.resize(10, 12);
+        ASSERT_TRUE_MSG(moved.capacity() >= 120, "Resize from inline to heap storage")
+        bool kept = true;
+        for (size_t i = 0; i < 10; ++i) {
+            for (size_t j = 0; j < 12; ++j) {
+                kept = kept && moved[i][j] == (i < 3 && j < 4 ? original[i][j] : 0.);
+            }
+        }
+        ASSERT_TRUE_MSG(kept, "Resize from inline to heap storage")
+
+        auto product = original * RandomMatrix(4, 2);
+        ASSERT_TRUE_MSG(product.capacity() == 16 && product.getRowsNum() == 3, "Small products stay inline")
+    }
+
+
+    {
+        Matrix mat(0, 5);
+        mat.reserve(100, 5);
+        size_t reserved = mat.capacity();
+        ASSERT_TRUE_MSG(reserved >= 500, "reserve()")
+
+        std::vector<std::vector<double>> rows;
+        for (size_t i = 0; i < 100; ++i) {
+            rows.push_back({RandomDouble(), RandomDouble(), RandomDouble(), RandomDouble(), RandomDouble()});
+            mat.appendRow(rows.back());
+        }
+        ASSERT_TRUE_MSG(mat.capacity() == reserved, "appendRow() within the reservation")
+
+        size_t reallocations = 0;
+        for (size_t i = 0; i < 1000; ++i) {
+            size_t before = mat.capacity();
+            rows.push_back({RandomDouble(), RandomDouble(), RandomDouble(), RandomDouble(), RandomDouble()});
+            mat.appendRow(rows.back());
+            reallocations += mat.capacity() != before;
+        }
+        ASSERT_TRUE_MSG(mat.getRowsNum() == 1100 && reallocations <= 5, "appendRow() grows geometrically")
+
+        std::vector<double> column;
+        for (size_t i = 0; i < 1100; ++i) {
+            column.push_back(RandomDouble());
+        }
+        mat.appendColumn(column);
+
+        bool same = mat.getColumnsNum() == 6;
+        for (size_t i = 0; i < 1100; ++i) {
+            for (size_t j = 0; j < 5; ++j) {
+                same = same && mat[i][j] == rows[i][j];
+            }
+            same = same && mat[i][5] == column[i];
+        }
+        ASSERT_TRUE_MSG(same, "appendRow() / appendColumn() values")
+
+        ASSERT_EXCEPTION_MSG(mat.appendRow(rows[0]), task::SizeMismatchException, "appendRow()")
+        ASSERT_EXCEPTION_MSG(mat.appendColumn(std::vector<double>(3)), task::SizeMismatchException, "appendColumn()")
+    }
+
+
+    {
+        auto mat1 = RandomMatrix(40, 50);
+        auto mat2 = mat1;
+        mat2[7][9] += 1e-3;
+        mat2[30][2] -= 5e-3;
+
+        auto first = mat1.compare(mat2);
+        ASSERT_TRUE_MSG(!first.equal && first.row == 7 && first.column == 9, "compare() first mismatch")
+        ASSERT_TRUE_MSG(std::fabs(first.max_deviation - 1e-3) < 1e-9, "compare() stops at the first mismatch")
+
+        auto full = mat1.compare(mat2, task::Tolerance::Absolute, EPS, false);
+        ASSERT_TRUE_MSG(!full.equal && full.row == 7 && full.column == 9, "compare() full scan")
+        ASSERT_TRUE_MSG(std::fabs(full.max_deviation - 5e-3) < 1e-9, "compare() full scan deviation")
+
+        Matrix scaled = mat1 * 1e6;
+        Matrix perturbed = scaled * (1. + 1e-10);
+        ASSERT_TRUE_MSG(!scaled.compare(perturbed).equal, "Absolute tolerance on large values")
+        ASSERT_TRUE_MSG(scaled.compare(perturbed, task::Tolerance::Relative, 1e-9).equal, "Relative tolerance")
+        ASSERT_TRUE_MSG(!scaled.compare(perturbed, task::Tolerance::Relative, 1e-11).equal, "Relative tolerance")
+
+        auto next = mat1;
+        next[0][0] = std::nextafter(next[0][0], HUGE_VAL);
+        auto ulp = mat1.compare(next, task::Tolerance::Ulp, 0.);
+        ASSERT_TRUE_MSG(!ulp.equal && ulp.max_deviation == 1., "ULP distance")
+        ASSERT_TRUE_MSG(mat1.compare(next, task::Tolerance::Ulp, 1.).equal, "ULP tolerance")
+
+        Matrix zeros = Matrix(2, 2) * 0.;
+        Matrix negative_zeros = Matrix(2, 2) * -0.;
+        ASSERT_TRUE_MSG(zeros.compare(negative_zeros, task::Tolerance::Ulp, 0.).equal, "+0 and -0 are 0 ULP apart")
+
+        auto nan = mat1;
+        nan[1][1] = NAN;
+        ASSERT_TRUE_MSG(nan != nan && !(nan == nan), "NaN never compares equal")
+        ASSERT_TRUE_MSG(!((nan + mat1 * 0.) == nan), "NaN never compares equal in expressions")
+        auto nan_result = nan.compare(nan, task::Tolerance::Relative, 1.);
+        ASSERT_TRUE_MSG(!nan_result.equal && nan_result.row == 1 && nan_result.column == 1, "NaN compare()")
+
+        ASSERT_EXCEPTION_MSG(mat1.compare(Matrix(2, 2)), task::SizeMismatchException, "compare() sizes")
+    }
+
+
+    REPEAT(5)
+    {
+        size_t n = RandomUInt(40, 130);
+        size_t crossover = RandomUInt(8, 32);
+        auto a = RandomMatrix(n, n);
+        auto b = RandomMatrix(n, n);
+
+        Matrix error = task::strassenMultiply(a, b, crossover);
+        error -= a * b;
+
+        // Both products are compared against each other, so allow the classic error as well.
+        double bound = (task::strassenErrorBound(n, crossover) + task::strassenErrorBound(n, n)) *
+                       a.maxAbs() * b.maxAbs();
+        ASSERT_TRUE_MSG(task::strassenErrorBound(n, n) < task::strassenErrorBound(n, crossover),
+                        "Strassen error bound grows with recursion")
+        ASSERT_TRUE_MSG(error.maxAbs() <= bound, "Strassen product within its error bound")
+
+        // Padded operands, padded result, workspace and the result itself.
+        CountingResource counting;
+        {
+            task::MatrixResourceScope scope(&counting);
+            Matrix scoped = task::strassenMultiply(a, b, crossover);
+        }
+        ASSERT_TRUE_MSG(counting.allocations() == 5, "Strassen buffers come from the matrix resource")
+    }
+
+
+    REPEAT(10)
+    {
+        size_t rows = RandomUInt(1, 120);
+        size_t inner = RandomUInt(1, 120);
+        size_t cols = RandomUInt(1, 120);
+
+        auto sparse_dense = [](size_t rows, size_t cols) {
+            Matrix result = Matrix(rows, cols) * 0.;
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < cols; j++) {
+                    if (RandomUInt(4) == 0) {
+                        result[i][j] = RandomDouble();
+                    }
+                }
+            }
+            return result;
+        };
+        Matrix dense_a = sparse_dense(rows, inner);
+        Matrix dense_b = sparse_dense(inner, cols);
+        task::SparseMatrix a(dense_a);
+        task::SparseMatrix b(dense_b);
+
+        ASSERT_TRUE_MSG(a.toMatrix() == dense_a, "Sparse from dense")
+        ASSERT_TRUE_MSG(a.transposed().toMatrix() == dense_a.transposed(), "Sparse transpose")
+
+        std::vector<task::Triplet> triplets;
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < inner; j++) {
+                if (dense_a[i][j] != 0.) {
+                    // Split each value in two to exercise summing duplicates.
+                    triplets.push_back({i, j, dense_a[i][j] / 2});
+                    triplets.push_back({i, j, dense_a[i][j] / 2});
+                }
+            }
+        }
+        std::shuffle(triplets.begin(), triplets.end(), std::mt19937(rows));
+        task::SparseMatrix from_triplets(rows, inner, triplets);
+        ASSERT_TRUE_MSG(from_triplets.nonZeros() == a.nonZeros() && from_triplets.toMatrix() == dense_a,
+                        "Sparse from triplets")
+
+        std::vector<double> x(inner);
+        for (double &value : x) {
+            value = RandomDouble();
+        }
+        std::vector<double> y = a * x;
+        std::vector<double> expected = dense_a * x;
+        bool vector_equal = y.size() == rows;
+        for (size_t i = 0; vector_equal && i < rows; i++) {
+            vector_equal = std::abs(y[i] - expected[i]) < task::EPS;
+        }
+        ASSERT_TRUE_MSG(vector_equal, "Sparse matrix-vector product")
+
+        Matrix dense_product = dense_a * dense_b;
+        ASSERT_TRUE_MSG(a * dense_b == dense_product, "Sparse-dense product")
+        ASSERT_TRUE_MSG((a * b).toMatrix() == dense_product, "Sparse-sparse product")
+    }
+
+
+    REPEAT(5)
+    {
+        const char *path = "matrix_test_roundtrip.bin";
+        auto mat = RandomMatrix(RandomUInt(1, 80), RandomUInt(1, 80));
+        size_t rows = mat.getRowsNum();
+        size_t cols = mat.getColumnsNum();
+
+        task::saveBinary(mat, path);
+        Matrix loaded = task::loadBinary(path);
+        ASSERT_TRUE_MSG(loaded.getRowsNum() == rows && loaded.getColumnsNum() == cols &&
+                        loaded.compare(mat, task::Tolerance::Absolute, 0.).equal, "Binary save / load")
+
+        {
+            task::MappedMatrix mapped(path);
+            ASSERT_TRUE_MSG(mapped.getRowsNum() == rows && mapped.getColumnsNum() == cols, "Mapped dimensions")
+            ASSERT_TRUE_MSG(mapped.verify(), "Mapped checksum")
+            Matrix viewed = mapped.view();
+            ASSERT_TRUE_MSG(viewed.compare(mat, task::Tolerance::Absolute, 0.).equal, "Mapped view")
+        }
+
+        {
+            // Flip one payload value; the header still checks out but the checksum does not.
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            double value = mat[rows - 1][cols - 1] + 1.;
+            file.seekp(64 + (rows * cols - 1) * sizeof(double));
+            file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+        ASSERT_EXCEPTION_MSG(task::loadBinary(path), task::MatrixFormatException, "Binary load of a corrupt payload")
+        ASSERT_TRUE_MSG(!task::MappedMatrix(path).verify(), "Mapped checksum of a corrupt payload")
+
+        std::remove(path);
+    }
+
+
+    REPEAT(10)
+    {
+        size_t n = RandomUInt(1, 90);
+        size_t rhs = RandomUInt(1, 5);
+        auto a = RandomMatrix(n, n);
+        auto b = RandomMatrix(n, rhs);
+
+        // Residuals are measured against the size of the terms that produced them.
+        auto small = [n](const Matrix &residual, double scale) {
+            return residual.maxAbs() <= 1e-10 * n * scale;
+        };
+
+        task::LUFactorization lu(a);
+        Matrix x = lu.solve(b);
+        Matrix residual = a * x;
+        residual -= b;
+        ASSERT_TRUE_MSG(small(residual, a.maxAbs() * x.maxAbs() + b.maxAbs()), "LU solve")
+
+        std::vector<double> column = b.getColumn(0);
+        std::vector<double> vector_x = lu.solve(column);
+        bool same = true;
+        for (size_t i = 0; i < n; i++) {
+            same = same && std::abs(vector_x[i] - x[i][0]) <= 1e-12 * (1. + std::abs(x[i][0]));
+        }
+        ASSERT_TRUE_MSG(same, "LU solve of a vector")
+
+        Matrix inverse = lu.inverse();
+        Matrix identity_error = a * inverse;
+        identity_error -= Matrix(n, n);
+        ASSERT_TRUE_MSG(small(identity_error, a.maxAbs() * inverse.maxAbs()), "LU inverse")
+
+        double det = a.det();
+        ASSERT_TRUE_MSG(std::abs(lu.det() - det) <= 1e-8 * std::abs(det), "LU det")
+
+        // A A^T + n I is symmetric positive definite and well conditioned.
+        Matrix spd = a * a.transposed();
+        spd += Matrix(n, n) * double(n);
+        task::CholeskyFactorization cholesky(spd);
+        x = cholesky.solve(b);
+        residual = spd * x;
+        residual -= b;
+        ASSERT_TRUE_MSG(small(residual, spd.maxAbs() * x.maxAbs() + b.maxAbs()), "Cholesky solve")
+
+        inverse = cholesky.inverse();
+        identity_error = spd * inverse;
+        identity_error -= Matrix(n, n);
+        ASSERT_TRUE_MSG(small(identity_error, spd.maxAbs() * inverse.maxAbs()), "Cholesky inverse")
+
+        double spd_det = spd.det();
+        ASSERT_TRUE_MSG(std::abs(cholesky.det() - spd_det) <= 1e-8 * std::abs(spd_det), "Cholesky det")
+
+        task::QRFactorization qr(a);
+        x = qr.solve(b);
+        residual = a * x;
+        residual -= b;
+        ASSERT_TRUE_MSG(small(residual, a.maxAbs() * x.maxAbs() + b.maxAbs()), "QR solve")
+
+        inverse = qr.inverse();
+        identity_error = a * inverse;
+        identity_error -= Matrix(n, n);
+        ASSERT_TRUE_MSG(small(identity_error, a.maxAbs() * inverse.maxAbs()), "QR inverse")
+        ASSERT_TRUE_MSG(std::abs(qr.det() - det) <= 1e-8 * std::abs(det), "QR det")
+
+        // For a tall A the least-squares residual is orthogonal to the columns of A.
+        auto tall = RandomMatrix(n + RandomUInt(1, 20), n);
+        auto tall_b = RandomMatrix(tall.getRowsNum(), rhs);
+        x = task::QRFactorization(tall).solve(tall_b);
+        residual = tall * x;
+        residual -= tall_b;
+        Matrix normal = tall.transposed() * residual;
+        ASSERT_TRUE_MSG(small(normal, tall.maxAbs() * (tall.maxAbs() * x.maxAbs() + tall_b.maxAbs()) * tall.getRowsNum()),
+                        "QR least squares")
+    }
+
+
+    {
+        Matrix singular = Matrix(3, 3);
+        singular[2][2] = 0.;
+        task::LUFactorization lu(singular);
+        ASSERT_TRUE_MSG(lu.det() == 0., "LU det of a singular matrix")
+        ASSERT_EXCEPTION_MSG(lu.inverse(), task::SingularMatrixException, "LU inverse of a singular matrix")
+
+        Matrix indefinite = Matrix(2, 2);
+        indefinite[1][1] = -1.;
+        ASSERT_EXCEPTION_MSG(task::CholeskyFactorization{indefinite}, task::NotPositiveDefiniteException,
+                             "Cholesky of an indefinite matrix")
+    }
+
+
+    {
+        task::set_num_threads(4);
+        auto failing = [](size_t i) {
+            if (i == 37) {
+                throw std::runtime_error("task");
+            }
+        };
+        ASSERT_EXCEPTION_MSG(task::ThreadPool::instance()->parallel_for(64, failing), std::runtime_error,
+                             "Thread pool rethrows task exceptions")
+
+        std::atomic<size_t> calls(0);
+        task::ThreadPool::instance()->parallel_for(64, [&](size_t) { calls++; });
+        ASSERT_TRUE_MSG(calls == 64, "Thread pool after a task exception")
+
+        // Resize the pool while another thread is using it.
+        auto mat = RandomMatrix(300, 300);
+        Matrix expected = mat * mat;
+        bool same = true;
+        std::thread user([&] {
+            for (int i = 0; i < 10; i++) {
+                same = same && mat * mat == expected;
+            }
+        });
+        for (size_t threads = 1; threads <= 8; threads++) {
+            task::set_num_threads(threads);
+        }
+        user.join();
+        ASSERT_TRUE_MSG(same, "Thread pool resize during a product")
+
+        task::set_num_threads(0);
+    }
+
+
+    REPEAT(5)
+    {
+        size_t rows = RandomUInt(1, 400);
+        size_t cols = RandomUInt(1, 400);
+        auto mat = RandomMatrix(rows, cols);
+
+        double squares = 0., largest = 0., row_largest = 0.;
+        std::vector<double> column_sums(cols, 0.);
+        for (size_t i = 0; i < rows; i++) {
+            double row_sum = 0.;
+            for (size_t j = 0; j < cols; j++) {
+                squares += mat[i][j] * mat[i][j];
+                largest = std::max(largest, std::abs(mat[i][j]));
+                row_sum += std::abs(mat[i][j]);
+                column_sums[j] += std::abs(mat[i][j]);
+            }
+            row_largest = std::max(row_largest, row_sum);
+        }
+        double column_largest = *std::max_element(column_sums.begin(), column_sums.end());
+
+        auto close = [](double x, double y) {
+            return std::abs(x - y) <= 1e-12 * std::abs(y);
+        };
+        ASSERT_TRUE_MSG(mat.maxAbs() == largest, "maxAbs()")
+        ASSERT_TRUE_MSG(close(mat.norm(), std::sqrt(squares)), "norm()")
+        ASSERT_TRUE_MSG(close(mat.norm1(), column_largest), "norm1()")
+        ASSERT_TRUE_MSG(close(mat.normInf(), row_largest), "normInf()")
+
+        // Squares of these overflow and underflow, but the norms stay in range.
+        double root = std::sqrt(double(rows * cols));
+        Matrix huge = mat * 1e300;
+        ASSERT_TRUE_MSG(close(huge.norm(), std::sqrt(squares) * 1e300), "norm() without overflow")
+        Matrix tiny = mat * 1e-300;
+        ASSERT_TRUE_MSG(std::abs(tiny.norm() - std::sqrt(squares) * 1e-300) <= 1e-12 * root * 1e-300 * largest,
+                        "norm() without underflow")
+
+        mat[RandomUInt(rows - 1)][RandomUInt(cols - 1)] = NAN;
+        ASSERT_TRUE_MSG(std::isnan(mat.maxAbs()) && std::isnan(mat.norm()) && std::isnan(mat.norm1()) &&
+                        std::isnan(mat.normInf()), "Norms propagate NaN")
+        ASSERT_TRUE_MSG(!std::isnan(mat.min()) && !std::isnan(mat.max()), "min() / max() skip NaN")
+    }
+
+    {
+        Matrix empty(0, 0);
+        ASSERT_TRUE_MSG(empty.maxAbs() == 0. && empty.norm() == 0. && empty.norm1() == 0. && empty.normInf() == 0.,
+                        "Norms of an empty matrix")
+        Matrix zeros = Matrix(3, 3) * 0.;
+        ASSERT_TRUE_MSG(zeros.norm() == 0., "norm() of zeros")
+    }
+
+
+    REPEAT(10)
+    {
+        size_t m = RandomUInt(1, 90);
+        size_t k = RandomUInt(1, 90);
+        size_t n = RandomUInt(1, 90);
+        auto big = RandomMatrix(m + k + 7, k + n + 5);
+        const Matrix &shared = big;
+
+        // Operands read in place through row / column strides, including a transposed one.
+        auto left = shared.block(3, 2, m, k);
+        auto right = shared.block(1, k + 2, k, n);
+        Matrix left_copy = left;
+        Matrix right_copy = right;
+        ASSERT_TRUE_MSG(left * right == left_copy * right_copy, "View product")
+
+        task::ConstMatrixView transposed(left.begin(), k, m, left.getColumnStride(), left.getRowStride());
+        ASSERT_TRUE_MSG(transposed * left_copy == left_copy.transposed() * left_copy, "Transposed view product")
+        ASSERT_TRUE_MSG((left_copy * 2.) * right == (left_copy * right_copy) * 2., "Expression times view")
+        ASSERT_EXCEPTION_MSG(left * Matrix(k + 1, 2), task::SizeMismatchException, "View product sizes")
+    }
+
+
+    REPEAT(20)
+    {
+        size_t n = RandomUInt(3, 4);
+        auto mat = RandomMatrix(n, n);
+        if (TossCoin()) {
+            mat[0][0] = 0.;
+        }
+        double expected = task::LUFactorization(mat).det();
+        ASSERT_TRUE_MSG(mat.det() == expected, "Inline det runs the LUFactorization kernel")
+
+        for (size_t j = 0; j < n; j++) {
+            mat[n - 1][j] = mat[0][j] * 2.;
+        }
+        ASSERT_TRUE_MSG(std::abs(mat.det()) <= 1e-12 * std::pow(mat.maxAbs(), double(n)), "Inline det of a singular matrix")
+    }
+
+
+    {
+        size_t count = RandomUInt(1, 700);
+        using RightBatch = task::MatrixBatch<4, 2>;
+        task::MatrixBatch<3, 4> left(count);
+        RightBatch right(count);
+        for (size_t k = 0; k < count; k++) {
+            for (size_t i = 0; i < 4; i++) {
+                for (size_t j = 0; j < 4; j++) {
+                    if (i < 3) {
+                        left(k, i, j) = RandomDouble();
+                    }
+                    if (j < 2) {
+                        right(k, i, j) = RandomDouble();
+                    }
+                }
+            }
+        }
+
+        bool aligned = true;
+        for (size_t i = 0; i < 3; i++) {
+            for (size_t j = 0; j < 4; j++) {
+                aligned = aligned && reinterpret_cast<uintptr_t>(left.lane(i, j)) % 64 == 0;
+            }
+        }
+        ASSERT_TRUE_MSG(aligned, "Batch lanes start on a cache line")
+
+        auto product = left * right;
+        bool same = product.size() == count;
+        for (size_t k = 0; same && k < count; k++) {
+            same = product.get(k) == left.get(k) * right.get(k);
+        }
+        ASSERT_TRUE_MSG(same, "Batch product")
+        ASSERT_EXCEPTION_MSG(left * RightBatch(count + 1), task::SizeMismatchException, "Batch product sizes")
+    }
+
+
+    {
+        const size_t huge = size_t(1) << 40;
+        ASSERT_EXCEPTION_MSG(Matrix(huge, huge), std::bad_alloc, "Constructor with an overflowing size")
+        ASSERT_EXCEPTION_MSG(Matrix(SIZE_MAX / 4, 1), std::bad_alloc, "Constructor with an overflowing byte count")
+
+        auto small = RandomMatrix(3, 3);
+        Matrix saved = small;
+        ASSERT_EXCEPTION_MSG(small.resize(huge, huge), std::bad_alloc, "Resize to an overflowing size")
+        ASSERT_EXCEPTION_MSG(small.reserve(huge, huge), std::bad_alloc, "Reserve of an overflowing size")
+        ASSERT_TRUE_MSG(small.getRowsNum() == 3 && small.getColumnsNum() == 3 && small == saved,
+                        "Inline matrix unchanged by a failed resize")
+
+        auto large = RandomMatrix(10, 10);
+        saved = large;
+        ASSERT_EXCEPTION_MSG(large.resize(SIZE_MAX / 8, 10), std::bad_alloc, "Resize of a heap matrix to an overflowing size")
+        ASSERT_TRUE_MSG(large == saved, "Heap matrix unchanged by a failed resize")
+    }
+
+
+    REPEAT(10)
+    {
+        size_t rows = RandomUInt(1, 600);
+        size_t cols = RandomUInt(1, 600);
+        auto mat = RandomMatrix(rows, cols);
+        auto random_vector = [](size_t size) {
+            std::vector<double> result(size);
+            for (double &value : result) {
+                value = RandomDouble();
+            }
+            return result;
+        };
+        auto close = [](const std::vector<double> &x, const std::vector<double> &y) {
+            bool same = x.size() == y.size();
+            for (size_t i = 0; same && i < x.size(); i++) {
+                same = std::abs(x[i] - y[i]) < task::EPS;
+            }
+            return same;
+        };
+
+        std::vector<double> x = random_vector(cols);
+        std::vector<double> row = random_vector(rows);
+        std::vector<double> expected(rows, 0.), expected_row(cols, 0.);
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                expected[i] += mat[i][j] * x[j];
+                expected_row[j] += row[i] * mat[i][j];
+            }
+        }
+        ASSERT_TRUE_MSG(close(mat * x, expected), "Matrix * vector")
+        ASSERT_TRUE_MSG(close(row * mat, expected_row), "Vector * matrix")
+
+        std::vector<double> y = random_vector(rows);
+        std::vector<double> updated(rows);
+        for (size_t i = 0; i < rows; i++) {
+            updated[i] = 2. * expected[i] - 0.5 * y[i];
+        }
+        task::gemv(2., mat, x, -0.5, y);
+        ASSERT_TRUE_MSG(close(y, updated), "gemv with beta")
+
+        std::vector<double> poisoned(cols, NAN);
+        task::gemv(1., mat, row, 0., poisoned, true);
+        ASSERT_TRUE_MSG(close(poisoned, expected_row), "Transposed gemv with beta == 0")
+
+        ASSERT_EXCEPTION_MSG(mat * std::vector<double>(cols + 1), task::SizeMismatchException, "Matrix * vector sizes")
+        ASSERT_EXCEPTION_MSG(std::vector<double>(rows + 1) * mat, task::SizeMismatchException, "Vector * matrix sizes")
+        std::vector<double> too_long(rows + 1);
+        ASSERT_EXCEPTION_MSG(task::gemv(1., mat, x, 0., too_long), task::SizeMismatchException, "gemv output size")
+
+        auto square = RandomMatrix(cols, cols);
+        std::vector<double> in_place = x;
+        task::gemv(1., square, in_place, 0., in_place);
+        ASSERT_TRUE_MSG(close(in_place, square * x), "gemv with x aliasing y")
+        in_place = x;
+        task::gemv(1., square, in_place, 1., in_place, true);
+        std::vector<double> aliased_expected = x * square;
+        for (size_t j = 0; j < cols; j++) {
+            aliased_expected[j] += x[j];
+        }
+        ASSERT_TRUE_MSG(close(in_place, aliased_expected), "Transposed gemv with x aliasing y")
+    }
+
+
+    REPEAT(5)
+    {
+        size_t m = RandomUInt(1, 80);
+        size_t n = RandomUInt(1, 80);
+        size_t k = RandomUInt(1, 80);
+
+        for (int flags = 0; flags < 4; flags++) {
+            bool transpose_a = flags & 1;
+            bool transpose_b = flags & 2;
+            auto a = transpose_a ? RandomMatrix(k, m) : RandomMatrix(m, k);
+            auto b = transpose_b ? RandomMatrix(n, k) : RandomMatrix(k, n);
+            auto c = RandomMatrix(m, n);
+
+            Matrix expected = c * 0.5;
+            for (size_t i = 0; i < m; i++) {
+                for (size_t j = 0; j < n; j++) {
+                    for (size_t p = 0; p < k; p++) {
+                        expected[i][j] += 2. * (transpose_a ? a[p][i] : a[i][p]) * (transpose_b ? b[j][p] : b[p][j]);
+                    }
+                }
+            }
+            task::gemm(2., a, b, 0.5, c, transpose_a, transpose_b);
+            ASSERT_TRUE_MSG(c == expected, "gemm with transpose flags and beta")
+
+            c[0][0] = HUGE_VAL;
+            c[m - 1][n - 1] = NAN;
+            task::gemm(1., a, b, 0., c, transpose_a, transpose_b);
+            Matrix product = (transpose_a ? a.transposed() : a) * (transpose_b ? b.transposed() : b);
+            ASSERT_TRUE_MSG(c == product, "gemm with beta == 0 ignores c")
+        }
+
+        auto square = RandomMatrix(n, n);
+        square[0][0] = HUGE_VAL;
+        Matrix other = RandomMatrix(n, n);
+        Matrix expected = square * other;
+        task::gemm(1., square, other, 0., square);
+        ASSERT_TRUE_MSG(square.compare(expected, task::Tolerance::Relative, 1e-12).equal,
+                        "Aliased gemm with beta == 0 ignores c")
+
+        auto aliased = RandomMatrix(n, n);
+        expected = aliased * aliased;
+        expected += aliased * 3.;
+        task::gemm(1., aliased, aliased, 3., aliased, false, false);
+        ASSERT_TRUE_MSG(aliased == expected, "Aliased gemm with beta")
+
+        ASSERT_EXCEPTION_MSG(task::gemm(1., RandomMatrix(2, 3), RandomMatrix(2, 3), 0., other), task::SizeMismatchException,
+                             "gemm sizes")
+    }
+
+
+    // Every column count up to two AVX-512 registers, on tight and on padded strides, so that
+    // each kernel's vector body and tail run on rows that do not start on a vector boundary.
+    for (size_t cols = 1; cols <= 17; cols++) {
+        size_t rows = RandomUInt(1, 9);
+        auto a = RandomMatrix(rows, cols);
+        auto b = RandomMatrix(rows, cols);
+
+        Matrix padded_a = RandomMatrix(rows + 2, cols + 5);
+        padded_a.resize(rows, cols);
+        Matrix padded_b = b;
+        padded_b.reserve(rows + 3, cols + 3);
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                padded_a[i][j] = a[i][j];
+            }
+        }
+        ASSERT_TRUE_MSG(padded_a.capacity() > rows * cols && padded_b.capacity() > rows * cols, "Padded strides")
+
+        std::vector<double> x(cols);
+        for (double &value : x) {
+            value = RandomDouble();
+        }
+        std::vector<double> expected_product(rows, 0.);
+        double expected_sum = 0.;
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                expected_product[i] += a[i][j] * x[j];
+                expected_sum += a[i][j];
+            }
+        }
+
+        for (int layout = 0; layout < 2; layout++) {
+            const Matrix &left = layout ? padded_a : a;
+            const Matrix &right = layout ? padded_b : b;
+
+            Matrix sum = left;
+            sum += right;
+            Matrix difference = left;
+            difference -= right;
+            Matrix scaled = left;
+            scaled *= 3.;
+            bool same = true;
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < cols; j++) {
+                    same = same && sum[i][j] == a[i][j] + b[i][j] && difference[i][j] == a[i][j] - b[i][j] &&
+                           scaled[i][j] == 3. * a[i][j];
+                }
+            }
+            ASSERT_TRUE_MSG(same, "Element-wise kernels on odd and padded rows")
+
+            std::vector<double> product = left * x;
+            for (size_t i = 0; i < rows; i++) {
+                same = same && std::abs(product[i] - expected_product[i]) < task::EPS;
+            }
+            ASSERT_TRUE_MSG(same, "Dot kernel on odd and padded rows")
+            ASSERT_TRUE_MSG(std::abs(left.sum() - expected_sum) < task::EPS, "Sum kernel on odd and padded rows")
+            ASSERT_TRUE_MSG(left == a && !(left == b) && left.compare(a, task::Tolerance::Ulp, 0.).equal,
+                            "Compare kernels on odd and padded rows")
+        }
+    }
+
+
+    // Shapes on and around the register tile (4 x 8) and the cache blocks (128, 256) of GEMM.
+    REPEAT(12)
+    {
+        const size_t sizes[] = {1, 3, 4, 5, 7, 8, 9, 31, 127, 128, 129, 255, 256, 257, 300};
+        const size_t count = sizeof(sizes) / sizeof(sizes[0]);
+        size_t m = sizes[RandomUInt(count - 1)];
+        size_t n = sizes[RandomUInt(count - 1)];
+        size_t k = sizes[RandomUInt(count - 1)];
+        auto a = RandomMatrix(m, k);
+        auto b = RandomMatrix(k, n);
+
+        Matrix expected = Matrix(m, n) * 0.;
+        for (size_t i = 0; i < m; i++) {
+            for (size_t p = 0; p < k; p++) {
+                for (size_t j = 0; j < n; j++) {
+                    expected[i][j] += a[i][p] * b[p][j];
+                }
+            }
+        }
+        ASSERT_TRUE_MSG(a * b == expected, "Blocked GEMM on odd shapes")
+    }
+
+
+    // FixedMatrix is evaluated at compile time where it can be.
+    {
+        constexpr task::Matrix3 fixed = [] {
+            task::Matrix3 m;
+            m(0, 0) = 2.;
+            m(0, 1) = 1.;
+            m(1, 2) = 4.;
+            m(2, 0) = -1.;
+            m(2, 2) = 3.;
+            return m;
+        }();
+        static_assert(fixed.trace() == 6., "constexpr FixedMatrix trace");
+        static_assert(fixed.det() == 2., "constexpr FixedMatrix det");
+        static_assert(task::Matrix4().det() == 1., "constexpr FixedMatrix identity det");
+    }
+
+
+    REPEAT(10)
+    {
+        using Wide = task::FixedMatrix<3, 4>;
+        Wide a;
+        task::FixedMatrix<4, 2> b;
+        for (size_t i = 0; i < 3; i++) {
+            for (size_t j = 0; j < 4; j++) {
+                a(i, j) = RandomDouble();
+            }
+        }
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t j = 0; j < 2; j++) {
+                b(i, j) = RandomDouble();
+            }
+        }
+
+        Matrix dynamic_a = a;
+        Matrix dynamic_b = b;
+        ASSERT_TRUE_MSG(dynamic_a.getRowsNum() == 3 && dynamic_a.getColumnsNum() == 4,
+                        "FixedMatrix to Matrix conversion shape")
+        ASSERT_TRUE_MSG(Matrix(a * b) == dynamic_a * dynamic_b, "FixedMatrix product")
+        ASSERT_TRUE_MSG(Matrix(a.transposed()) == dynamic_a.transposed(), "FixedMatrix transposed")
+        ASSERT_TRUE_MSG(Wide(dynamic_a) == a, "Matrix to FixedMatrix round trip")
+
+        task::Matrix3 square(RandomMatrix(3, 3));
+        Matrix dynamic_square = square;
+        ASSERT_TRUE_MSG(std::abs(square.det() - dynamic_square.det()) < task::EPS, "FixedMatrix det")
+        ASSERT_TRUE_MSG(std::abs(square.trace() - dynamic_square.trace()) < task::EPS, "FixedMatrix trace")
+
+        ASSERT_EXCEPTION_MSG(task::Matrix3(RandomMatrix(3, 4)), task::SizeMismatchException,
+                             "Matrix to FixedMatrix with wrong columns")
+        ASSERT_EXCEPTION_MSG(task::Matrix3(RandomMatrix(2, 3)), task::SizeMismatchException,
+                             "Matrix to FixedMatrix with wrong rows")
+    }
+
+
+    // Moved-from matrices stay usable, and moves never allocate.
+    REPEAT(10)
+    {
+        size_t rows = RandomUInt(5, 40);
+        size_t cols = RandomUInt(5, 40);
+        auto a = RandomMatrix(rows, cols);
+        auto small = RandomMatrix(2, 3);
+
+        Matrix source = a;
+        Matrix moved(std::move(source));
+        ASSERT_TRUE_MSG(moved == a, "Move constructor keeps the elements")
+        ASSERT_TRUE_MSG(source.getRowsNum() == 0 && source.getColumnsNum() == 0, "Moved-from matrix is empty")
+        source = small;
+        ASSERT_TRUE_MSG(source == small, "Moved-from matrix can be assigned to")
+        source.resize(3, 3);
+        ASSERT_TRUE_MSG(source.getRowsNum() == 3 && source.getColumnsNum() == 3, "Moved-from matrix can be resized")
+
+        Matrix inline_source = small;
+        Matrix inline_moved = std::move(inline_source);
+        ASSERT_TRUE_MSG(inline_moved == small, "Move of an inline matrix keeps the elements")
+        inline_source = a;
+        ASSERT_TRUE_MSG(inline_source == a, "Moved-from inline matrix can be assigned to")
+
+        Matrix target = small;
+        target = std::move(moved);
+        ASSERT_TRUE_MSG(target == a, "Move assignment keeps the elements")
+        moved = target * 2.;
+        ASSERT_TRUE_MSG(moved == a * 2., "Matrix moved from by assignment can be assigned to")
+
+        Matrix self = a;
+        Matrix &alias = self;
+        self = std::move(alias);
+        ASSERT_TRUE_MSG(self == a, "Self move assignment is a no-op")
+
+        auto b = RandomMatrix(rows, cols);
+        auto c = RandomMatrix(rows, cols);
+        auto d = RandomMatrix(rows, cols);
+        Matrix expected = a;
+        expected += b;
+        expected += c;
+        expected -= d;
+
+        CountingResource counting;
+        {
+            task::MatrixResourceScope scope(&counting);
+            Matrix chain = a + b + c - d;
+            ASSERT_TRUE_MSG(chain == expected, "Chained sum")
+            Matrix stolen = std::move(chain);
+            Matrix assigned;
+            assigned = std::move(stolen);
+            ASSERT_TRUE_MSG(assigned == expected, "Chained sum after moves")
+        }
+        ASSERT_TRUE_MSG(counting.allocations() == 1, "Chained sum and moves allocate once")
+    }
+
+
+    // Lazy expressions: self-aliasing, views mixed into products, and fused evaluation.
+    REPEAT(10)
+    {
+        size_t rows = RandomUInt(5, 40);
+        size_t inner = RandomUInt(5, 40);
+        size_t cols = RandomUInt(5, 40);
+        auto a = RandomMatrix(rows, inner);
+        auto b = RandomMatrix(rows, inner);
+        auto c = RandomMatrix(inner, cols);
+        const Matrix &const_a = a;
+        const Matrix &const_c = c;
+
+        Matrix tripled = a * 3.;
+        Matrix self = a;
+        self = self + self * 2.;
+        ASSERT_TRUE_MSG(self == tripled, "Self-aliasing expression")
+        Matrix shared = a;
+        Matrix copy = shared;
+        shared = shared + copy * 2.;
+        ASSERT_TRUE_MSG(shared == tripled && copy == a, "Self-aliasing expression on a shared buffer")
+
+        Matrix sum = a;
+        sum += b;
+        Matrix expected = sum * c;
+        ASSERT_TRUE_MSG((a + b) * c == expected, "Expression times matrix")
+        ASSERT_TRUE_MSG((a + b) * const_c.view() == expected, "Expression times view")
+        ASSERT_TRUE_MSG(const_a.view() * c + b * c == expected, "View product plus matrix product")
+
+        size_t block_rows = RandomUInt(1, rows);
+        size_t block_inner = RandomUInt(1, inner);
+        Matrix block = Matrix(block_rows, block_inner) * 0.;
+        for (size_t i = 0; i < block_rows; i++) {
+            for (size_t j = 0; j < block_inner; j++) {
+                block[i][j] = a[i][j] - b[i][j];
+            }
+        }
+        Matrix c_rows = Matrix(block_inner, cols) * 0.;
+        for (size_t i = 0; i < block_inner; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                c_rows[i][j] = c[i][j];
+            }
+        }
+        Matrix block_product = const_a.block(0, 0, block_rows, block_inner) * const_c.block(0, 0, block_inner, cols) -
+                               b.block(0, 0, block_rows, block_inner) * c_rows;
+        ASSERT_TRUE_MSG(block_product == block * c_rows, "Product of blocks inside an expression")
+
+        auto d = RandomMatrix(rows, inner);
+        Matrix fused_expected = a * 2.;
+        fused_expected += b;
+        fused_expected -= d;
+        Matrix refused_expected = fused_expected - a + b * 0.5;
+        CountingResource counting;
+        {
+            task::MatrixResourceScope scope(&counting);
+            Matrix fused = 2. * a + b - d;
+            ASSERT_TRUE_MSG(fused == fused_expected, "Fused expression")
+            fused = -a + b * 0.5 + fused;
+            ASSERT_TRUE_MSG(fused == refused_expected, "Fused expression into a matrix of the same shape")
+        }
+        ASSERT_TRUE_MSG(counting.allocations() == 1, "Fused expressions allocate only their result")
+    }
+
+
+    // In-place transpose() on each storage layout: inline, dense heap, and padded rows left by a shrink.
+    REPEAT(20)
+    {
+        size_t shapes[][2] = {{1, 1}, {2, 5}, {3, 4}, {4, 4}, {1, 16}, {RandomUInt(1, 80), RandomUInt(1, 80)},
+                              {RandomUInt(30, 70), RandomUInt(30, 70)}};
+        for (auto &shape : shapes) {
+            size_t rows = shape[0];
+            size_t cols = shape[1];
+            auto a = RandomMatrix(rows, cols);
+
+            Matrix expected = Matrix(cols, rows) * 0.;
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < cols; j++) {
+                    expected[j][i] = a[i][j];
+                }
+            }
+
+            Matrix dense = a;
+            dense.transpose();
+            ASSERT_TRUE_MSG(dense == expected, "transpose() of a dense matrix")
+            dense.transpose();
+            ASSERT_TRUE_MSG(dense == a, "transpose() twice")
+
+            size_t pad_rows = RandomUInt(0, 3);
+            size_t pad_cols = RandomUInt(1, 3);
+            Matrix padded = RandomMatrix(rows + pad_rows, cols + pad_cols);
+            padded.resize(rows, cols);
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < cols; j++) {
+                    padded[i][j] = a[i][j];
+                }
+            }
+            padded.transpose();
+            ASSERT_TRUE_MSG(padded == expected, "transpose() of a matrix with padded rows")
+            padded.resize(cols + 1, rows + 1);
+            bool grown = padded[cols][rows] == 0.;
+            for (size_t i = 0; i < cols; i++) {
+                for (size_t j = 0; j < rows; j++) {
+                    grown = grown && padded[i][j] == expected[i][j];
+                }
+            }
+            ASSERT_TRUE_MSG(grown, "resize() after transpose()")
+        }
+    }
+
+
     const int STRESS_TEST_COUNT = argc > 1 ? std::stoi(argv[1]) : 0;
 
     REPEAT(STRESS_TEST_COUNT)